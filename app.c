@@ -97,6 +97,7 @@ ProtoViewApp* protoview_app_alloc() {
 
     /* Storage for persisting TPMS data. */
     app->storage = furi_record_open(RECORD_STORAGE);
+    detect_profiles_load(app);
 
     /* GUI setup. */
     app->gui = furi_record_open(RECORD_GUI);
@@ -119,7 +120,25 @@ ProtoViewApp* protoview_app_alloc() {
     app->signal_decoded = false;
     app->us_scale = PROTOVIEW_RAW_VIEW_DEFAULT_SCALE;
     app->signal_offset = 0;
-    app->msg_info = NULL;
+    app->scan_top_k = SCAN_DEFAULT_TOP_K;
+    app->scan_budget_us = SCAN_DEFAULT_BUDGET_US;
+    app->scan_step_budget_us = SCAN_DEFAULT_STEP_BUDGET_US;
+    memset(&app->scan, 0, sizeof(app->scan));
+    app->scan.phase = ScanPhaseIdle;
+    app->scan.copy = raw_samples_alloc();
+    memset(&app->negcache, 0, sizeof(app->negcache));
+    app->decode.bitmap = malloc(DECODE_ARENA_SIZE);
+    memset(app->decode.bitmap, 0, DECODE_ARENA_SIZE);
+    app->decode.dirty = 0;
+    app->decode.debug_str = LOG_ENABLED(LOG_LEVEL_DEBUG) ?
+                             malloc(DECODE_DEBUG_STR_LEN) : NULL;
+    app->decode.eval_all = TPMS_EVAL_ALL;
+    app->decode.eval_saved = NULL;
+    app->decode.crc_fix = TPMS_CRC_FIX;
+    app->decode.known = &app->sensor_list;
+    app->decode.nummatches = 0;
+    app->decode.votes = malloc(COMBINE_MAX_BITS);
+    decoder_rank_init(&app->rank);
 
     /* Radio. */
     app->txrx = malloc(sizeof(ProtoViewTxRx));
@@ -151,6 +170,19 @@ ProtoViewApp* protoview_app_alloc() {
     app->dbg_decode_ok_count = 0;
     app->dbg_last_signal_len = 0;
     app->dbg_last_signal_dur = 0;
+    app->dbg_deferred_count = 0;
+    app->dbg_scan_step_count = 0;
+    app->dbg_budget_hit_count = 0;
+    app->dbg_negcache_hit = 0;
+    app->dbg_negcache_miss = 0;
+    memset(app->dbg_rate_wins, 0, sizeof(app->dbg_rate_wins));
+    app->dbg_inverted_ok_count = 0;
+    app->dbg_sync_errors_ok_count = 0;
+    app->dbg_decoder_skip_count = 0;
+    app->dbg_decoder_call_count = 0;
+    app->dbg_decode_conflict_count = 0;
+    app->dbg_crc_fixed_ok_count = 0;
+    app->dbg_combined_ok_count = 0;
 
     /* SD card debug logging (always on). */
     app->debug_logging = true;
@@ -182,6 +214,12 @@ void protoview_app_free(ProtoViewApp *app) {
 
     raw_samples_free(RawSamples);
     raw_samples_free(DetectedSamples);
+    scan_free_msgs(app);
+    raw_samples_free(app->scan.copy);
+    free(app->decode.bitmap);
+    free(app->decode.debug_str);
+    free(app->decode.eval_saved);
+    free(app->decode.votes);
     furi_hal_power_suppress_charge_exit();
 
     free(app);
@@ -227,21 +265,29 @@ static void timer_callback(void *ctx) {
     }
 }
 
-/* Process pending scan work — called from the main loop. */
+/* Process pending scan work — called from the main loop. A new scan is
+ * started only when the previous one is complete; otherwise the scan in
+ * progress is continued for one step, and we return to the event loop if
+ * it was paused by the step budget. */
 static void process_signal_scan(ProtoViewApp *app) {
-    app->signal_last_scan_idx = RawSamples->idx;
-
-    scan_for_signal(app, RawSamples,
-                    ProtoViewModulations[app->modulation].duration_filter);
-
-    /* If a signal was decoded, extract TPMS data and reset for the next. */
-    if (app->signal_decoded && app->msg_info) {
-        tpms_extract_and_store(app);
+    if (!scan_in_progress(app)) {
+        app->signal_last_scan_idx = RawSamples->idx;
+        scan_start(app, RawSamples, &ProtoViewModulations[app->modulation]);
+    }
+    if (!scan_step(app)) return; /* Continue on the next iteration. */
+    if (app->dbg_scan_count % 32 == 0) tpms_debug_log_stats(app);
+
+    /* Store every frame the scan decoded, so that sensors transmitting
+     * together are all seen at once, and reset for the next. */
+    bool stored = false;
+    for (uint32_t j = 0; j < app->scan.nummsgs; j++)
+        if (tpms_extract_and_store(app, app->scan.msgs[j])) stored = true;
+    if (stored) tpms_notify_rx(app);
+    scan_free_msgs(app);
+    if (app->signal_decoded) {
         app->signal_bestlen = 0;
         app->signal_decoded = false;
         raw_samples_reset(DetectedSamples);
-        free_msg_info(app->msg_info);
-        app->msg_info = NULL;
     }
 }
 
@@ -278,10 +324,12 @@ int32_t protoview_app_entry(void* p) {
 
     InputEvent input;
     while(app->running) {
-        FuriStatus qstat = furi_message_queue_get(app->event_queue, &input, 100);
+        /* Don't sleep waiting for input while a scan is paused: it is
+         * resumed below as soon as pending events are handled. */
+        uint32_t timeout = scan_in_progress(app) ? 0 : 100;
+        FuriStatus qstat = furi_message_queue_get(app->event_queue, &input, timeout);
         if (qstat == FuriStatusOk) {
-            if (DEBUG_MSG) FURI_LOG_E(TAG, "Input: type %d key %u",
-                    input.type, input.key);
+            LOG_D("Input: type %d key %u", input.type, input.key);
 
             /* Navigation: Back exits from sub-views or quits. */
             if (input.type == InputTypeShort && input.key == InputKeyBack) {
@@ -325,16 +373,14 @@ int32_t protoview_app_entry(void* p) {
                     break;
                 }
             }
-        } else {
-            if (DEBUG_MSG) {
-                static int c = 0; c++;
-                if (!(c % 20)) FURI_LOG_E(TAG, "Loop timeout");
-            }
+        } else if (timeout && LOG_ENABLED(LOG_LEVEL_DEBUG)) {
+            static int c = 0; c++;
+            if (!(c % 20)) LOG_D("Loop timeout");
         }
 
         /* Process flags set by the lightweight timer callback.
          * This runs in the main thread so it won't block the GUI. */
-        if (app->should_scan) {
+        if (app->should_scan || scan_in_progress(app)) {
             app->should_scan = false;
             process_signal_scan(app);
         }
@@ -346,6 +392,7 @@ int32_t protoview_app_entry(void* p) {
         view_port_update(app->view_port);
     }
 
+    trace_dump(app);
     tpms_debug_log(app, "STOP", "");
 
     /* Stop the timer before shutting down the radio so the timer
@@ -355,7 +402,7 @@ int32_t protoview_app_entry(void* p) {
     furi_timer_free(timer);
 
     if (app->txrx->txrx_state == TxRxStateRx) {
-        FURI_LOG_E(TAG, "Putting CC1101 to sleep before exiting.");
+        LOG_I("Putting CC1101 to sleep before exiting.");
         radio_rx_end(app);
         radio_sleep(app);
     }
@@ -22,6 +22,9 @@
 #include <lib/subghz/registry.h>
 #include <storage/storage.h>
 #include "raw_samples.h"
+#include "bitops.h"
+#include "bit_cursor.h"
+#include "trace.h"
 
 #define TAG "TPMSReader"
 #define TPMS_READER_VERSION "2.4"
@@ -29,7 +32,84 @@
 #define BITMAP_SEEK_NOT_FOUND UINT32_MAX
 #define PROTOVIEW_VIEW_PRIVDATA_LEN 64
 
-#define DEBUG_MSG 1
+/* Signal scanning: coherent runs found in the buffer are scored and only
+ * the best SCAN_DEFAULT_TOP_K are sent to the decoders, within a CPU budget
+ * measured with the DWT cycle counter. The remaining candidates are
+ * deferred: they stay in the ring and are seen again by the next scan.
+ * The scan itself is resumable: each main loop iteration runs it for at
+ * most SCAN_DEFAULT_STEP_BUDGET_US, so input and redraws are not blocked. */
+#define SCAN_MAX_CANDIDATES 32
+#define SCAN_MAX_MSGS 8         /* Decoded messages kept per scan. */
+#define SCAN_DEFAULT_TOP_K 4
+#define SCAN_DEFAULT_BUDGET_US 30000
+#define SCAN_DEFAULT_STEP_BUDGET_US 10000
+
+/* Repeat combining: sensors send each frame a few times in a burst. Runs
+ * that no decoder accepted, but where the sync of the same decoder was
+ * found, are aligned on it and majority voted bit by bit, and the result
+ * is decoded once. At least COMBINE_MIN_COPIES are needed for a majority,
+ * at most COMBINE_MAX_COPIES are combined. Frames longer than
+ * COMBINE_MAX_BITS sampled bits are not combined. */
+#define COMBINE_MIN_COPIES 3
+#define COMBINE_MAX_COPIES 8
+#define COMBINE_MAX_BITS 512
+#define COMBINE_TAIL_BITS 16        /* Combined after the frame. */
+
+/* Negative-result cache: runs that failed every decoder are remembered by
+ * a hash of their samples and stream position, and not decoded again by
+ * later scans of the same ring contents. Runs where a decoder's sync was
+ * found keep it, so that they can still be combined with repeats that
+ * arrive later, see scan_combine(). */
+#define NEGCACHE_SIZE 64
+
+/* Adaptive decoder order: decoders are tried first where they recently
+ * succeeded with the same preset. Hits decay by half every
+ * RANK_DECAY_HITS decodes of the preset, so the order follows the
+ * sensors currently around. */
+#define RANK_MAX_PRESETS 16
+#define RANK_MAX_DECODERS 32
+#define RANK_DECAY_HITS 32
+
+/* Decoding scratch memory: decode_signal() samples runs into a bitmap
+ * preallocated with the app, instead of allocating one per attempt, and
+ * the decoders only see the bytes actually sampled. A pulse produces at
+ * most DECODE_MAX_PULSE_BITS bits. */
+#define DECODE_MAX_PULSE_BITS 1024
+#define DECODE_ARENA_SIZE 4096      /* Bytes, 32768 bits. */
+#define DECODE_DEBUG_STR_LEN 1024
+
+/* Evaluate-all decoding: instead of keeping the first decoder that
+ * accepts a run, every eligible decoder is run at every rate, each
+ * result is scored (check strength, sync quality, field plausibility, see
+ * decode_eval_score()) and the best one is kept. Slower: meant to resolve
+ * overlapping protocols and to log all the matches for analysis. Build
+ * with TPMS_EVAL_ALL=1 to enable it. */
+#ifndef TPMS_EVAL_ALL
+#define TPMS_EVAL_ALL 0
+#endif
+#define DECODE_MAX_MATCHES 8
+
+/* CRC error correction: when no decoder accepts a run as received, the
+ * decoders with crc_fix set are called again at their exact sync matches,
+ * allowed to correct a single bit error in their CRC8, see
+ * decoder_fix_crc8(). Most syndromes of a CRC8 over a TPMS frame are the
+ * one of some single bit error, so a corrected frame is only accepted
+ * from a sensor already in the list, and with plausible pressure and
+ * temperature. Build with TPMS_CRC_FIX=0 to disable. */
+#ifndef TPMS_CRC_FIX
+#define TPMS_CRC_FIX 1
+#endif
+
+/* Rate hypotheses tried by decode_signal(). When a run contains only long
+ * pulses (Manchester runs of equal bits, preambles) the measured short
+ * pulse can be twice the real symbol time, so if the measured rate does
+ * not decode, half of it and the nominal protocol rates are tried too. */
+typedef enum {
+    RateHypMeasured,            /* Short pulse measured by the scanner. */
+    RateHypHalf,                /* Half of the measured short pulse. */
+    RateHypNominal,             /* Nominal symbol time of a decoder. */
+    RateHypCount
+} ProtoViewRateHyp;
 
 /* ========================= TPMS Sensor Tracking ============================ */
 
@@ -86,12 +166,40 @@ typedef enum {
 
 /* ================================== RX/TX ================================= */
 
+/* Detection profile: how coherent runs are searched in the samples and
+ * how much of the signal around them is passed to the decoders. Each
+ * modulation has its own, so that presets can be tuned for the pulse
+ * widths and frame lengths of their protocols. The defaults can be
+ * overridden from the SD card, see detect_profiles_load(). */
+#define DETECT_MAX_CLASSES 4
+typedef struct {
+    uint32_t minlen;            /* Shortest run (in pulses) to decode. */
+    uint32_t max_duration;      /* Longer pulses end a run (us). */
+    uint32_t search_classes;    /* Pulse classes per level, up to
+                                   DETECT_MAX_CLASSES. */
+    uint32_t class_tolerance_div; /* A pulse joins a class if it is within
+                                     class average / this. */
+    uint32_t before_samples;    /* Samples decoded before the run. */
+    uint32_t after_samples;     /* Samples decoded after the run. */
+} ProtoViewDetectProfile;
+
+#define DETECT_PROFILE_DEFAULT {30, 6000, 3, 3, 32, 100}
+
+/* Modulation classes, as a mask: a preset demodulates one of them, and a
+ * decoder declares the ones its protocol can be received with. Decoders
+ * are only called on signals captured with a matching preset. */
+#define MOD_CLASS_OOK (1 << 0)
+#define MOD_CLASS_FSK (1 << 1)
+#define MOD_CLASS_ANY (MOD_CLASS_OOK | MOD_CLASS_FSK)
+
 typedef struct {
     const char *name;
     const char *id;
     FuriHalSubGhzPreset preset;
     uint8_t *custom;
     uint32_t duration_filter;
+    ProtoViewDetectProfile profile;
+    uint32_t mod_class;         /* MOD_CLASS_OOK or MOD_CLASS_FSK. */
 } ProtoViewModulation;
 
 extern ProtoViewModulation ProtoViewModulations[];
@@ -106,6 +214,97 @@ struct ProtoViewTxRx {
 
 typedef struct ProtoViewTxRx ProtoViewTxRx;
 
+/* ============================ Signal scanning ============================= */
+
+/* A coherent run found by the scanner, waiting to be decoded. */
+typedef struct {
+    uint32_t off;               /* Offset of the run in the scanned copy. */
+    uint32_t len;               /* Number of coherent samples. */
+    uint32_t short_pulse_dur;   /* Estimated symbol time of the run. */
+    int32_t level_bias;         /* Estimated high/low bias of the run. */
+    uint32_t score;             /* Higher is more promising. */
+    uint32_t key;               /* Negative cache key, see run_cache_key(). */
+    bool failed;                /* Failed in an earlier scan: only kept
+                                   for combining, see ProtoViewNegCache. */
+    uint32_t decoded;           /* Bit of the decoder that accepted it. */
+    /* If no decoder accepted it: the decoders whose sync was found without
+     * errors, in the run as received and inverted. See scan_combine(). */
+    uint32_t synced[2];
+} ProtoViewScanCandidate;
+
+typedef enum {
+    ScanPhaseIdle,      /* No scan in progress. */
+    ScanPhaseCollect,   /* Searching coherent runs in the copy. */
+    ScanPhaseDecode,    /* Decoding the sorted candidates. */
+    ScanPhaseCombine,   /* Combining the repeats that failed. */
+} ProtoViewScanPhase;
+
+/* State of the resumable scanner, kept across main loop iterations. */
+typedef struct {
+    ProtoViewScanPhase phase;
+    RawSamplesBuffer *copy;     /* Snapshot of the samples being scanned. */
+    uint32_t min_duration;      /* Duration filter of the scanned preset. */
+    ProtoViewDetectProfile profile; /* Detection profile of the preset. */
+    uint32_t mod_class;         /* Modulation class of the preset. */
+    uint32_t preset;            /* Index of the preset in ProtoViewModulations. */
+    uint32_t cursor;            /* Next sample (collect) or candidate
+                                   (decode, combine). */
+    uint32_t group;             /* Combine: next decoder and polarity of
+                                   the candidate, rank * 2 + inverted. */
+    uint32_t decode_cycles;     /* Cycles spent decoding in this scan. */
+    ProtoViewScanCandidate cand[SCAN_MAX_CANDIDATES];
+    uint32_t numcand;
+    ProtoViewMsgInfo *msgs[SCAN_MAX_MSGS]; /* Decoded by this scan, in
+                                   decode order, repeats removed. */
+    uint32_t nummsgs;
+} ProtoViewScanState;
+
+/* Keys of runs that no decoder could decode. Zero marks an empty slot. */
+typedef struct {
+    uint32_t keys[NEGCACHE_SIZE];
+    uint32_t synced[NEGCACHE_SIZE][2]; /* See ProtoViewScanCandidate. */
+    uint32_t next;              /* Slot to overwrite on the next insert. */
+} ProtoViewNegCache;
+
+/* Hits and current decoder order, per preset. order[] holds indexes of
+ * Decoders[]: a decoder that can decode the same frames as one before it
+ * in Decoders[] never passes it, so overlapping protocols keep their
+ * priority, see decoder_rank_hit(). */
+typedef struct {
+    uint8_t order[RANK_MAX_PRESETS][RANK_MAX_DECODERS];
+    uint16_t hits[RANK_MAX_PRESETS][RANK_MAX_DECODERS];
+    uint16_t decodes[RANK_MAX_PRESETS]; /* Since the last decay. */
+} ProtoViewDecoderRank;
+
+/* A decoder that accepted the run in evaluate-all mode. */
+typedef struct {
+    uint8_t decoder;            /* Index in Decoders[]. */
+    bool inverted;              /* Decoded from the inverted signal. */
+    bool kept;                  /* The result decode_signal() returned. */
+    int16_t score;              /* See decode_eval_score(). */
+    uint16_t rate;              /* Symbol time the run was sampled at. */
+} ProtoViewDecodeMatch;
+
+/* Scratch memory owned by the app and reused by every decode_signal()
+ * call. Only the first 'dirty' bytes of the bitmap can be non zero, so
+ * only those are cleared before sampling the next run. */
+typedef struct {
+    uint8_t *bitmap;            /* DECODE_ARENA_SIZE bytes. */
+    uint32_t dirty;             /* Bytes written since the last clear. */
+    char *debug_str;            /* Sampled bits as text, for LOG_D(). */
+    bool eval_all;              /* See TPMS_EVAL_ALL. */
+    uint8_t *eval_saved;        /* Evaluate-all mode: the bitmap before the
+                                   decoders run, allocated on first use. */
+    bool crc_fix;               /* See TPMS_CRC_FIX. */
+    TPMSSensorList *known;      /* Sensors corrected frames can be from. */
+    ProtoViewDecodeMatch matches[DECODE_MAX_MATCHES]; /* Of the last
+                                   decode_signal() in evaluate-all mode. */
+    uint32_t nummatches;
+    uint32_t synced[2];         /* Of the last decode_signal(), see
+                                   ProtoViewScanCandidate. */
+    uint8_t *votes;             /* COMBINE_MAX_BITS counters. */
+} ProtoViewDecodeCtx;
+
 /* ============================== Main app state ============================ */
 
 #define ALERT_MAX_LEN 32
@@ -133,7 +332,13 @@ struct ProtoViewApp {
     uint32_t signal_bestlen;
     uint32_t signal_last_scan_idx;
     bool signal_decoded;
-    ProtoViewMsgInfo *msg_info;
+    uint32_t scan_top_k;        /* Max candidates decoded per scan. */
+    uint32_t scan_budget_us;    /* Max decode time per scan. */
+    uint32_t scan_step_budget_us; /* Max scan time per main loop iteration. */
+    ProtoViewScanState scan;    /* Resumable scanner state. */
+    ProtoViewNegCache negcache; /* Runs that already failed decoding. */
+    ProtoViewDecodeCtx decode;  /* Scratch memory of decode_signal(). */
+    ProtoViewDecoderRank rank;  /* Adaptive decoder order. */
     void *view_privdata;
 
     /* Raw view state (kept for compatibility with signal.c). */
@@ -164,6 +369,21 @@ struct ProtoViewApp {
     uint32_t dbg_decode_ok_count;   /* Successful TPMS decodes. */
     uint32_t dbg_last_signal_len;   /* Sample count of last coherent signal. */
     uint32_t dbg_last_signal_dur;   /* Short pulse duration of last signal. */
+    uint32_t dbg_deferred_count;    /* Candidates left for a later scan. */
+    uint32_t dbg_scan_step_count;   /* Scanner steps run by the main loop. */
+    uint32_t dbg_budget_hit_count;  /* Steps paused by the step budget. */
+    uint32_t dbg_negcache_hit;      /* Runs skipped: already failed. */
+    uint32_t dbg_negcache_miss;     /* Runs not found in the cache. */
+    uint32_t dbg_rate_wins[RateHypCount]; /* Decodes per rate hypothesis. */
+    uint32_t dbg_inverted_ok_count; /* Decodes of inverted signals. */
+    uint32_t dbg_sync_errors_ok_count; /* Decodes with sync bit errors. */
+    uint32_t dbg_decoder_skip_count; /* Decoders filtered out before the
+                                        call, by preset, rate or length. */
+    uint32_t dbg_decoder_call_count; /* Decoder calls. */
+    uint32_t dbg_decode_conflict_count; /* Runs accepted by more than one
+                                           decoder (evaluate-all mode). */
+    uint32_t dbg_crc_fixed_ok_count; /* Decodes after a CRC correction. */
+    uint32_t dbg_combined_ok_count; /* Decodes of combined repeats. */
 
     bool debug_logging;             /* SD card debug log enabled. */
 };
@@ -171,6 +391,7 @@ struct ProtoViewApp {
 /* =========================== Protocols decoders =========================== */
 
 #define PROTOVIEW_MSG_STR_LEN 32
+#define DECODER_MAX_SYNC 4
 typedef struct ProtoViewMsgInfo {
     ProtoViewDecoder *decoder;
     ProtoViewFieldSet *fieldset;
@@ -179,6 +400,20 @@ typedef struct ProtoViewMsgInfo {
     uint32_t short_pulse_dur;
     uint8_t *bits;
     uint32_t bits_bytes;
+    /* Offset of the first match of each of the decoder sync patterns, or
+     * BITMAP_SEEK_NOT_FOUND. Set by decode_signal() before calling the
+     * decoder. */
+    uint32_t sync_off[DECODER_MAX_SYNC];
+    /* Bits of the sync pattern found at sync_off[] that differ from the
+     * pattern, up to the decoder sync_max_errors. */
+    uint8_t sync_errors[DECODER_MAX_SYNC];
+    /* True if the message was decoded from the inverted signal, see
+     * allow_inverted in ProtoViewDecoder. */
+    bool inverted;
+    /* Set by decode_signal() when the decoder may correct a bit error in
+     * the CRC, see decoder_fix_crc8(), that counts them in fixed_bits. */
+    bool fix_errors;
+    uint8_t fixed_bits;
 } ProtoViewMsgInfo;
 
 typedef enum {
@@ -209,11 +444,115 @@ typedef struct ProtoViewFieldSet {
     uint32_t numfields;
 } ProtoViewFieldSet;
 
+/* A "0101..." bit pattern compiled to words, so that it can be searched
+ * in a bitmap without walking the string at every offset. Patterns are
+ * up to BIT_PATTERN_MAX_LEN bits: the last 'len' bits of 'value', and of
+ * 'mask', that selects which of them must match. */
+#define BIT_PATTERN_MAX_LEN 64
+typedef struct {
+    uint64_t value;
+    uint64_t mask;
+    uint32_t len;
+} BitPattern;
+
+/* Declarative protocols: a payload of fixed length after the sync
+ * pattern, decoded with the decoder line code, checked by a checksum and
+ * made of fields at fixed bit offsets. Decoders that fit set 'desc'
+ * instead of 'decode', and are run by proto_engine.c. */
+typedef enum {
+    ProtoCheckNone,
+    ProtoCheckCrc8,
+    ProtoCheckCrc16,
+    ProtoCheckSum8,             /* Sum of the bytes, modulo 256. */
+    ProtoCheckXor8,             /* XOR of the bytes. */
+} ProtoViewCheckKind;
+
+typedef struct {
+    uint8_t kind;               /* ProtoViewCheckKind. */
+    uint8_t from, len;          /* Payload bytes covered. */
+    int8_t at;                  /* Payload byte with the expected value
+                                   (CRC16: two bytes, big endian), or -1
+                                   if the check of the bytes must give 0. */
+    uint16_t poly, init;        /* CRC polynomial, initial value. */
+} ProtoViewCheckDesc;
+
+typedef struct {
+    const char *name;
+    uint8_t type;               /* ProtoViewFieldType, except FieldTypeStr. */
+    uint16_t bitpos;            /* First bit in the payload, MSB first. */
+    uint8_t width;              /* Bits, up to 32. Bytes: a multiple of 8. */
+    uint8_t digits;             /* Float: digits after the dot. */
+    float scale, offset;        /* Float: raw * scale + offset.
+                                   Signed int: raw + offset. */
+} ProtoViewFieldDesc;
+
+#define PROTO_DESC_MANCHESTER_10_IS_0 (1 << 0) /* Instead of 01 = 0. */
+
+typedef struct {
+    uint8_t len;                /* Payload bytes after the sync. */
+    uint8_t flags;              /* PROTO_DESC_... */
+    ProtoViewCheckDesc check;
+    const ProtoViewFieldDesc *fields; /* Terminated by a NULL name. */
+} ProtoViewProtoDesc;
+
+/* Line code of a protocol payload, as sampled at the symbol time. */
+typedef enum {
+    LineCodeNRZ,                /* One symbol per bit. */
+    LineCodeManchester,         /* 10 and 01 symbol pairs. */
+    LineCodeDiffManchester,     /* Differential Manchester. */
+    LineCodePWM,                /* Pulse width: short/long pulse pairs. */
+} ProtoViewLineCode;
+
 typedef struct ProtoViewDecoder {
     const char *name;
     bool (*decode)(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo *info);
     void (*get_fields)(ProtoViewFieldSet *fields);
     void (*build_message)(RawSamplesBuffer *samples, ProtoViewFieldSet *fields);
+    /* NULL terminated list of up to DECODER_MAX_SYNC preamble/sync
+     * patterns. They are all searched in a single pass over the bitmap,
+     * and the decoder is only called if at least one of them was found,
+     * see info->sync_off. Decoders without patterns are always called. */
+    const char **sync;
+    /* If true, the decoder is tried again on the inverted bitmap when no
+     * decoder matches the signal as received. For protocols where the
+     * level assignment (FSK deviation, Manchester convention) depends on
+     * the preset, and the payload is checked by a CRC. */
+    bool allow_inverted;
+    /* Flipped bits accepted when matching the sync patterns, for long
+     * preambles where a single error would lose an otherwise good frame.
+     * The decoder is called at the exact matches first, and again at the
+     * approximate ones if that fails. */
+    uint8_t sync_max_errors;
+
+    /* What the protocol looks like on air. decode_signal() only calls the
+     * decoder when the preset modulation class is among 'mod_class', the
+     * rate the signal is sampled at is within symbol_min_us and
+     * symbol_max_us, and at least min_bits were sampled. The nominal
+     * symbol times of all the decoders are the rates tried when the
+     * measured one fails. A zero mod_class or symbol range accepts
+     * anything. */
+    uint8_t mod_class;          /* MOD_CLASS_... mask. */
+    uint8_t line_code;          /* ProtoViewLineCode of the payload. */
+    uint16_t symbol_us;         /* Nominal symbol (shortest pulse) time. */
+    uint16_t symbol_min_us;     /* Range of symbol times accepted. */
+    uint16_t symbol_max_us;
+    uint16_t min_bits;          /* Sampled bits of a frame, sync included. */
+    /* Longest frame, in the same bits. Informational for the dispatcher,
+     * that doesn't filter on it: a run often holds a preamble or several
+     * repeats besides the frame, so it can be longer than any frame. It
+     * bounds the bits repeat combining votes on, see decode_combined(). */
+    uint16_t max_bits;
+    /* Strength of the frame check in bits: the CRC width, or 6 for an 8
+     * bit sum or XOR, that miss more errors; 0 if there is no check.
+     * Used to rank decoders accepting the same run, see
+     * decode_eval_score(). */
+    uint8_t check_bits;
+    /* The decoder checks its CRC8 with decoder_fix_crc8(), see
+     * TPMS_CRC_FIX. */
+    bool crc_fix;
+
+    /* Declarative protocol, used when 'decode' is NULL. */
+    const ProtoViewProtoDesc *desc;
 } ProtoViewDecoder;
 
 extern RawSamplesBuffer *RawSamples, *DetectedSamples;
@@ -227,18 +566,27 @@ void raw_sampling_worker_start(ProtoViewApp *app);
 void raw_sampling_worker_stop(ProtoViewApp *app);
 void radio_tx_signal(ProtoViewApp *app, FuriHalSubGhzAsyncTxCallback data_feeder, void *ctx);
 void protoview_rx_callback(bool level, uint32_t duration, void* context);
+void detect_profiles_load(ProtoViewApp *app);
 
 /* signal.c */
 uint32_t duration_delta(uint32_t a, uint32_t b);
 void reset_current_signal(ProtoViewApp *app);
-void scan_for_signal(ProtoViewApp *app, RawSamplesBuffer *source, uint32_t min_duration);
+void scan_for_signal(ProtoViewApp *app, RawSamplesBuffer *source, const ProtoViewModulation *mod);
+void scan_start(ProtoViewApp *app, RawSamplesBuffer *source, const ProtoViewModulation *mod);
+bool scan_step(ProtoViewApp *app);
+bool scan_in_progress(ProtoViewApp *app);
+void scan_free_msgs(ProtoViewApp *app);
 bool bitmap_get(uint8_t *b, uint32_t blen, uint32_t bitpos);
 void bitmap_set(uint8_t *b, uint32_t blen, uint32_t bitpos, bool val);
+void bitmap_set_run(uint8_t *b, uint32_t blen, uint32_t bitpos, uint32_t count, bool val);
+void bitmap_invert(uint8_t *b, uint32_t blen, uint32_t numbits);
 void bitmap_copy(uint8_t *d, uint32_t dlen, uint32_t doff, uint8_t *s, uint32_t slen, uint32_t soff, uint32_t count);
 void bitmap_set_pattern(uint8_t *b, uint32_t blen, uint32_t off, const char *pat);
 void bitmap_reverse_bytes_bits(uint8_t *p, uint32_t len);
 bool bitmap_match_bits(uint8_t *b, uint32_t blen, uint32_t bitpos, const char *bits);
 uint32_t bitmap_seek_bits(uint8_t *b, uint32_t blen, uint32_t startpos, uint32_t maxbits, const char *bits);
+bool bitmap_pattern_compile(BitPattern *p, const char *bits);
+uint32_t bitmap_seek_pattern(uint8_t *b, uint32_t blen, uint32_t startpos, uint32_t maxbits, const BitPattern *p);
 bool bitmap_match_bitmap(uint8_t *b1, uint32_t b1len, uint32_t b1off,
                          uint8_t *b2, uint32_t b2len, uint32_t b2off,
                          uint32_t cmplen);
@@ -248,14 +596,26 @@ uint32_t convert_from_line_code(uint8_t *buf, uint64_t buflen, uint8_t *bits, ui
 uint32_t convert_from_diff_manchester(uint8_t *buf, uint64_t buflen, uint8_t *bits, uint32_t len, uint32_t off, bool previous);
 uint32_t diff_manchester_decode(uint8_t *buf, uint32_t buflen, uint8_t *bits, uint32_t numbytes, uint32_t off, uint32_t max_bits);
 void init_msg_info(ProtoViewMsgInfo *i, ProtoViewApp *app);
+void decoder_rank_init(ProtoViewDecoderRank *rank);
+void decoder_rank_hit(ProtoViewDecoderRank *rank, uint32_t preset, const ProtoViewDecoder *decoder);
 void free_msg_info(ProtoViewMsgInfo *i);
+bool decoder_fix_crc8(ProtoViewMsgInfo *info, uint8_t *data, uint32_t len, uint8_t init, uint8_t poly);
 
 /* tpms_sensor.c */
 void tpms_sensor_list_init(TPMSSensorList *list);
 void tpms_sensor_list_clear(TPMSSensorList *list);
-bool tpms_extract_and_store(ProtoViewApp *app);
+bool tpms_extract_and_store(ProtoViewApp *app, ProtoViewMsgInfo *info);
+void tpms_notify_rx(ProtoViewApp *app);
+bool tpms_sensor_known(TPMSSensorList *list, const char *protocol, ProtoViewFieldSet *fs);
 void tpms_save_to_file(ProtoViewApp *app, TPMSSensor *sensor);
 void tpms_debug_log(ProtoViewApp *app, const char *event, const char *detail);
+File *tpms_debug_log_open(ProtoViewApp *app);
+void tpms_debug_log_write(ProtoViewApp *app, File *file, const char *event, const char *detail);
+void tpms_debug_log_close(File *file);
+void tpms_debug_log_stats(ProtoViewApp *app);
+
+/* trace.c */
+void trace_dump(ProtoViewApp *app);
 
 /* view_tpms_list.c */
 void render_view_tpms_list(Canvas *const canvas, ProtoViewApp *app);
@@ -282,6 +642,7 @@ void canvas_draw_str_with_border(Canvas* canvas, uint8_t x, uint8_t y, const cha
 /* fields.c */
 void fieldset_free(ProtoViewFieldSet *fs);
 ProtoViewFieldSet *fieldset_new(void);
+ProtoViewField *fieldset_find(ProtoViewFieldSet *fs, const char *name);
 void fieldset_add_int(ProtoViewFieldSet *fs, const char *name, int64_t val, uint8_t bits);
 void fieldset_add_uint(ProtoViewFieldSet *fs, const char *name, uint64_t uval, uint8_t bits);
 void fieldset_add_hex(ProtoViewFieldSet *fs, const char *name, uint64_t uval, uint8_t bits);
@@ -296,8 +657,12 @@ bool field_incr_value(ProtoViewField *f, int incr);
 void fieldset_copy_matching_fields(ProtoViewFieldSet *dst, ProtoViewFieldSet *src);
 void field_set_from_field(ProtoViewField *dst, ProtoViewField *src);
 
+/* proto_engine.c */
+bool proto_desc_decode(const ProtoViewDecoder *d, uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo *info);
+
 /* crc.c */
 uint8_t crc8(const uint8_t *data, size_t len, uint8_t init, uint8_t poly);
 uint16_t crc16(const uint8_t *data, size_t len, uint16_t init, uint16_t poly);
+int crc8_fix_single_bit(uint8_t *data, size_t len, uint8_t init, uint8_t poly);
 uint8_t sum_bytes(const uint8_t *data, size_t len, uint8_t init);
 uint8_t xor_bytes(const uint8_t *data, size_t len, uint8_t init);
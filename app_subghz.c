@@ -13,28 +13,105 @@
 void raw_sampling_timer_start(ProtoViewApp *app);
 void raw_sampling_timer_stop(ProtoViewApp *app);
 
+/* The 40 kBaud presets receive protocols with 25 us symbols, where even
+ * preambles and sync words are made of pulses of a few hundred us, so
+ * runs are cut at much shorter pulses there. */
+#define DETECT_PROFILE_40K {30, 1000, 3, 3, 32, 100}
+
 ProtoViewModulation ProtoViewModulations[] = {
     {"OOK 650Khz", "FuriHalSubGhzPresetOok650Async",
-                    FuriHalSubGhzPresetOok650Async, NULL, 30},
+                    FuriHalSubGhzPresetOok650Async, NULL, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_OOK},
     {"OOK 270Khz", "FuriHalSubGhzPresetOok270Async",
-                    FuriHalSubGhzPresetOok270Async, NULL, 30},
+                    FuriHalSubGhzPresetOok270Async, NULL, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_OOK},
     {"2FSK 2.38Khz", "FuriHalSubGhzPreset2FSKDev238Async",
-                    FuriHalSubGhzPreset2FSKDev238Async, NULL, 30},
+                    FuriHalSubGhzPreset2FSKDev238Async, NULL, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_FSK},
     {"2FSK 47.6Khz", "FuriHalSubGhzPreset2FSKDev476Async",
-                    FuriHalSubGhzPreset2FSKDev476Async, NULL, 30},
+                    FuriHalSubGhzPreset2FSKDev476Async, NULL, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_FSK},
     {"TPMS US (FSK)", NULL,
-                    0, (uint8_t*)protoview_subghz_tpms_us_fsk_async_regs, 30},
+                    0, (uint8_t*)protoview_subghz_tpms_us_fsk_async_regs, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_FSK},
     {"OOK 650kHz", NULL,
-                    0, (uint8_t*)protoview_subghz_tpms2_ook_async_regs, 30},
+                    0, (uint8_t*)protoview_subghz_tpms2_ook_async_regs, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_OOK},
     {"GFSK 20kBaud", NULL,
-                    0, (uint8_t*)protoview_subghz_tpms3_gfsk_async_regs, 30},
+                    0, (uint8_t*)protoview_subghz_tpms3_gfsk_async_regs, 30,
+                    DETECT_PROFILE_DEFAULT, MOD_CLASS_FSK},
     {"OOK 40kBaud", NULL,
-                    0, (uint8_t*)protoview_subghz_40k_ook_async_regs, 15},
+                    0, (uint8_t*)protoview_subghz_40k_ook_async_regs, 15,
+                    DETECT_PROFILE_40K, MOD_CLASS_OOK},
     {"FSK 40kBaud", NULL,
-                    0, (uint8_t*)protoview_subghz_40k_fsk_async_regs, 15},
-    {NULL, NULL, 0, NULL, 0} /* End of list sentinel. */
+                    0, (uint8_t*)protoview_subghz_40k_fsk_async_regs, 15,
+                    DETECT_PROFILE_40K, MOD_CLASS_FSK},
+    {NULL, NULL, 0, NULL, 0, {0}, 0} /* End of list sentinel. */
 };
 
+#define DETECT_PROFILES_PATH APP_DATA_PATH("detect_profiles.txt")
+#define DETECT_PROFILES_FILETYPE "TPMS Reader detection profiles"
+
+/* Apply the profiles found in the already opened file 'ff'. */
+static void detect_profiles_parse(FlipperFormat *ff) {
+    for (int j = 0; ProtoViewModulations[j].name != NULL; j++) {
+        uint32_t v[6];
+        flipper_format_rewind(ff);
+        if (!flipper_format_read_uint32(ff, ProtoViewModulations[j].name,
+                                        v, COUNT_OF(v))) continue;
+
+        /* The context around a run must leave room for the run itself
+         * in the ring, written so that the sum can't overflow. */
+        if (v[0] == 0 || v[1] == 0 || v[2] == 0 ||
+            v[2] > DETECT_MAX_CLASSES || v[3] < 2 ||
+            v[4] >= RAW_SAMPLES_NUM || v[5] >= RAW_SAMPLES_NUM - v[4])
+        {
+            LOG_W("Invalid detection profile for %s",
+                ProtoViewModulations[j].name);
+            continue;
+        }
+        ProtoViewDetectProfile *p = &ProtoViewModulations[j].profile;
+        p->minlen = v[0];
+        p->max_duration = v[1];
+        p->search_classes = v[2];
+        p->class_tolerance_div = v[3];
+        p->before_samples = v[4];
+        p->after_samples = v[5];
+        LOG_I("Loaded detection profile for %s",
+            ProtoViewModulations[j].name);
+    }
+}
+
+/* Override the detection profiles of the modulations with the ones found
+ * in DETECT_PROFILES_PATH, if the file exists. Called once at startup.
+ * Every key is the name of a modulation, and its value the six profile
+ * fields, in the order of ProtoViewDetectProfile:
+ *
+ *  Filetype: TPMS Reader detection profiles
+ *  Version: 1
+ *  FSK 40kBaud: 30 800 3 3 32 100
+ *
+ * Modulations not listed keep their built-in profile, and profiles with
+ * out of range values are ignored. */
+void detect_profiles_load(ProtoViewApp *app) {
+    if (!app->storage) return;
+
+    FlipperFormat *ff = flipper_format_file_alloc(app->storage);
+    FuriString *filetype = furi_string_alloc();
+    uint32_t version;
+
+    if (flipper_format_file_open_existing(ff, DETECT_PROFILES_PATH) &&
+        flipper_format_read_header(ff, filetype, &version) &&
+        furi_string_cmp_str(filetype, DETECT_PROFILES_FILETYPE) == 0 &&
+        version == 1)
+    {
+        detect_profiles_parse(ff);
+    }
+
+    furi_string_free(filetype);
+    flipper_format_free(ff);
+}
+
 /* Called after the application initialization in order to setup the
  * subghz system and put it into idle state. */
 void radio_begin(ProtoViewApp* app) {
@@ -81,7 +158,7 @@ void protoview_rx_callback(bool level, uint32_t duration, void *context) {
     UNUSED(context);
     /* Add data to the circular buffer. */
     raw_samples_add(RawSamples, level, duration);
-    // FURI_LOG_E(TAG, "FEED: %d %d", (int)level, (int)duration);
+    // LOG_D("FEED: %d %d", (int)level, (int)duration);
     return;
 }
 
@@ -96,7 +173,7 @@ uint32_t radio_rx(ProtoViewApp* app) {
 
     furi_hal_subghz_idle(); /* Put it into idle state in case it is sleeping. */
     uint32_t value = furi_hal_subghz_set_frequency_and_path(app->frequency);
-    FURI_LOG_E(TAG, "Switched to frequency: %lu", value);
+    LOG_I("Switched to frequency: %lu", value);
     furi_hal_gpio_init(&gpio_cc1101_g0, GpioModeInput, GpioPullNo, GpioSpeedLow);
     furi_hal_subghz_flush_rx();
     furi_hal_subghz_rx();
@@ -151,7 +228,7 @@ void radio_tx_signal(ProtoViewApp *app, FuriHalSubGhzAsyncTxCallback data_feeder
 
     furi_hal_subghz_idle();
     uint32_t value = furi_hal_subghz_set_frequency_and_path(app->frequency);
-    FURI_LOG_E(TAG, "Switched to frequency: %lu", value);
+    LOG_I("Switched to frequency: %lu", value);
     furi_hal_gpio_write(&gpio_cc1101_g0, false);
     furi_hal_gpio_init(&gpio_cc1101_g0, GpioModeOutputPushPull, GpioPullNo, GpioSpeedLow);
 
@@ -203,7 +280,7 @@ void raw_sampling_worker_start(ProtoViewApp *app) {
     furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, protoview_timer_isr, app);
     LL_TIM_EnableIT_UPDATE(TIM2);
     LL_TIM_EnableCounter(TIM2);
-    FURI_LOG_E(TAG, "Timer enabled");
+    LOG_D("Timer enabled");
 }
 
 void raw_sampling_worker_stop(ProtoViewApp *app) {
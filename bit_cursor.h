@@ -0,0 +1,166 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license.
+ *
+ * Bit cursors: sequential readers and writers of bitmaps (MSB first, like
+ * bitmap_get() and bitmap_set()), that move whole bytes in and out of a
+ * 64 bit cache instead of handling one bit at a time. Used by the decoders
+ * to extract fields at arbitrary bit offsets, and by bitmap_copy().
+ *
+ * This file only depends on the C library and bitops.h, so that it can be
+ * tested and benchmarked on the host, see tests/bench_bitmap_copy.c. */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bitops.h"
+
+typedef struct {
+    const uint8_t *buf;
+    uint32_t len;       /* Length of 'buf' in bytes. */
+    uint32_t next;      /* Next byte to load into the cache. */
+    uint64_t cache;     /* Bits not yet consumed, left aligned. */
+    uint32_t avail;     /* Number of valid bits in the cache. */
+} BitReader;
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t len;       /* Length of 'buf' in bytes. */
+    uint32_t next;      /* Next byte to store from the cache. */
+    uint64_t cache;     /* Bits not yet stored, left aligned. */
+    uint32_t count;     /* Number of valid bits in the cache. */
+} BitWriter;
+
+/* Load bytes into the cache until it holds at least 57 bits. Bytes past
+ * the end of the buffer read as zero, like bitmap_get() does. */
+static inline void bit_reader_refill(BitReader *r) {
+    if (r->next + 8 <= r->len) {
+        /* Fast path: load 8 bytes at once. The bits of the last byte that
+         * don't fit are loaded again by the next refill, in the same
+         * position, so ORing them twice is harmless. */
+        const uint8_t *p = r->buf + r->next;
+        uint64_t v = ((uint64_t)bitops_load_be32(p) << 32) |
+                     bitops_load_be32(p + 4);
+        uint32_t bytes = (64 - r->avail) / 8;
+        r->cache |= v >> r->avail;
+        r->avail += bytes * 8;
+        r->next += bytes;
+        return;
+    }
+    while (r->avail <= 56) {
+        uint64_t byte = r->next < r->len ? r->buf[r->next] : 0;
+        r->cache |= byte << (56 - r->avail);
+        r->avail += 8;
+        r->next++;
+    }
+}
+
+/* Return the next 'n' bits (0 to 32) without consuming them. */
+static inline uint32_t bit_reader_peek(BitReader *r, uint32_t n) {
+    if (n == 0) return 0;
+    if (r->avail < n) bit_reader_refill(r);
+    return r->cache >> (64 - n);
+}
+
+/* Consume 'n' bits. */
+static inline void bit_reader_skip(BitReader *r, uint32_t n) {
+    while (n) {
+        uint32_t k = n > 32 ? 32 : n;
+        if (r->avail < k) bit_reader_refill(r);
+        r->cache <<= k;
+        r->avail -= k;
+        n -= k;
+    }
+}
+
+/* Return and consume the next 'n' bits (0 to 32). */
+static inline uint32_t bit_reader_get(BitReader *r, uint32_t n) {
+    uint32_t v = bit_reader_peek(r, n);
+    bit_reader_skip(r, n);
+    return v;
+}
+
+/* Start reading the 'len' bytes of 'buf' at bit offset 'off'. */
+static inline void bit_reader_init(BitReader *r, const uint8_t *buf,
+                                   uint32_t len, uint32_t off)
+{
+    r->buf = buf;
+    r->len = len;
+    r->next = off / 8;
+    r->cache = 0;
+    r->avail = 0;
+    bit_reader_skip(r, off & 7);
+}
+
+/* Store the complete bytes of the cache. Bytes past the end of the buffer
+ * are discarded, like bitmap_set() does. */
+static inline void bit_writer_drain(BitWriter *w) {
+    if (w->count >= 32 && w->next + 4 <= w->len) {
+        bitops_store_be32(w->buf + w->next, w->cache >> 32);
+        w->next += 4;
+        w->cache <<= 32;
+        w->count -= 32;
+    }
+    while (w->count >= 8) {
+        if (w->next < w->len) w->buf[w->next] = w->cache >> 56;
+        w->next++;
+        w->cache <<= 8;
+        w->count -= 8;
+    }
+}
+
+/* Append the low 'n' bits (0 to 32) of 'v'. */
+static inline void bit_writer_put(BitWriter *w, uint32_t v, uint32_t n) {
+    if (n == 0) return;
+    uint64_t bits = v & (uint32_t)(0xffffffffUL >> (32 - n));
+    w->cache |= bits << (64 - w->count - n);
+    w->count += n;
+    if (w->count > 32) bit_writer_drain(w);
+}
+
+/* Start writing the 'len' bytes of 'buf' at bit offset 'off'. The bits
+ * before 'off' in the first byte are preserved. */
+static inline void bit_writer_init(BitWriter *w, uint8_t *buf, uint32_t len,
+                                   uint32_t off)
+{
+    w->buf = buf;
+    w->len = len;
+    w->next = off / 8;
+    w->cache = 0;
+    w->count = 0;
+    uint32_t skew = off & 7;
+    if (skew && w->next < len)
+        bit_writer_put(w, buf[w->next] >> (8 - skew), skew);
+    else
+        w->count = skew;
+}
+
+/* Store the bits still in the cache. The bits of the last byte after the
+ * end of the written data are preserved. */
+static inline void bit_writer_flush(BitWriter *w) {
+    bit_writer_drain(w);
+    if (w->count && w->next < w->len) {
+        uint8_t keep = 0xff >> w->count;
+        w->buf[w->next] = (w->buf[w->next] & keep) |
+                          ((uint8_t)(w->cache >> 56) & ~keep);
+    }
+    w->count = 0;
+}
+
+/* Copy 'count' bits from 's' at bit offset 'soff' to 'd' at bit offset
+ * 'doff', 32 bits at a time. */
+static inline void bit_cursor_copy(uint8_t *d, uint32_t dlen, uint32_t doff,
+                                   const uint8_t *s, uint32_t slen,
+                                   uint32_t soff, uint32_t count)
+{
+    BitReader r;
+    BitWriter w;
+    bit_reader_init(&r, s, slen, soff);
+    bit_writer_init(&w, d, dlen, doff);
+    while (count >= 32) {
+        bit_writer_put(&w, bit_reader_get(&r, 32), 32);
+        count -= 32;
+    }
+    bit_writer_put(&w, bit_reader_get(&r, count), count);
+    bit_writer_flush(&w);
+}
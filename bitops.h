@@ -0,0 +1,134 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license.
+ *
+ * Bit manipulation kernels used by the bitmap, line code and CRC code.
+ *
+ * On the Flipper (Cortex-M4) they map to single instructions: RBIT, REV
+ * and CLZ, with unaligned word loads and stores, that the M4 supports.
+ * Everywhere else the portable versions below are used. Both are always
+ * compiled, so that tests/test_bitops.c can check that they agree.
+ *
+ * This file only depends on the C library, like bit_cursor.h. */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__arm__) && defined(__ARM_ARCH_7EM__)
+#define BITOPS_CORTEX_M4 1
+#else
+#define BITOPS_CORTEX_M4 0
+#endif
+
+/* ============================ Portable kernels ============================ */
+
+/* Reverse the order of the 32 bits of 'x'. */
+static inline uint32_t bitops_rbit32_portable(uint32_t x) {
+    x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+    x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+    x = ((x >> 8) & 0x00ff00ff) | ((x & 0x00ff00ff) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+/* Reverse the order of the 4 bytes of 'x'. */
+static inline uint32_t bitops_rev32_portable(uint32_t x) {
+    return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+}
+
+/* Number of leading zero bits of 'x', 32 if 'x' is zero. */
+static inline uint32_t bitops_clz32_portable(uint32_t x) {
+    if (x == 0) return 32;
+    uint32_t n = 0;
+    if ((x & 0xffff0000) == 0) { n += 16; x <<= 16; }
+    if ((x & 0xff000000) == 0) { n += 8; x <<= 8; }
+    if ((x & 0xf0000000) == 0) { n += 4; x <<= 4; }
+    if ((x & 0xc0000000) == 0) { n += 2; x <<= 2; }
+    if ((x & 0x80000000) == 0) { n += 1; }
+    return n;
+}
+
+/* ============================ Selected kernels ============================ */
+
+#if BITOPS_CORTEX_M4
+static inline uint32_t bitops_rbit32(uint32_t x) {
+    uint32_t r;
+    __asm__ ("rbit %0, %1" : "=r" (r) : "r" (x));
+    return r;
+}
+static inline uint32_t bitops_rev32(uint32_t x) {
+    uint32_t r;
+    __asm__ ("rev %0, %1" : "=r" (r) : "r" (x));
+    return r;
+}
+static inline uint32_t bitops_clz32(uint32_t x) {
+    uint32_t r;
+    __asm__ ("clz %0, %1" : "=r" (r) : "r" (x));
+    return r;
+}
+#else
+#define bitops_rbit32 bitops_rbit32_portable
+#define bitops_rev32 bitops_rev32_portable
+#define bitops_clz32 bitops_clz32_portable
+#endif
+
+/* ====================== Kernels built on the above ======================= */
+
+/* Number of trailing zero bits of 'x', 32 if 'x' is zero. */
+static inline uint32_t bitops_ctz32(uint32_t x) {
+    return bitops_clz32(bitops_rbit32(x));
+}
+
+/* Number of set bits of 'x'. The M4 has no population count instruction,
+ * but the multiply is single cycle. */
+static inline uint32_t bitops_popcount32(uint32_t x) {
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f;
+    return (x * 0x01010101) >> 24;
+}
+
+static inline uint32_t bitops_popcount64(uint64_t x) {
+    return bitops_popcount32((uint32_t)x) + bitops_popcount32(x >> 32);
+}
+
+/* Reverse the bits of each of the 4 bytes of 'x', leaving the bytes in
+ * place: RBIT reverses the bytes order too, and REV restores it. */
+static inline uint32_t bitops_rbit8x4(uint32_t x) {
+    return bitops_rev32(bitops_rbit32(x));
+}
+
+/* Load and store 32 bits as big endian, that is, in bitmap order, from
+ * any address. memcpy() compiles to a single load or store. */
+static inline uint32_t bitops_load_be32(const uint8_t *p) {
+    uint32_t x;
+    memcpy(&x, p, 4);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    x = bitops_rev32(x);
+#endif
+    return x;
+}
+
+static inline void bitops_store_be32(uint8_t *p, uint32_t x) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    x = bitops_rev32(x);
+#endif
+    memcpy(p, &x, 4);
+}
+
+/* One byte of MSB first CRC8 / CRC16 update, without branches: the
+ * polynomial is selected by a mask made from the top bit. */
+static inline uint8_t bitops_crc8_byte(uint8_t crc, uint8_t byte, uint8_t poly) {
+    uint32_t c = crc ^ byte;
+    for (int j = 0; j < 8; j++)
+        c = (c << 1) ^ (poly & -((c >> 7) & 1));
+    return c;
+}
+
+static inline uint16_t bitops_crc16_byte(uint16_t crc, uint8_t byte, uint16_t poly) {
+    uint32_t c = crc ^ ((uint32_t)byte << 8);
+    for (int j = 0; j < 8; j++)
+        c = (c << 1) ^ (poly & -((c >> 15) & 1));
+    return c;
+}
@@ -3,22 +3,17 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include "bitops.h"
 
 /* CRC8 with the specified initialization value 'init' and
  * polynomial 'poly'. */
 uint8_t crc8(const uint8_t *data, size_t len, uint8_t init, uint8_t poly)
 {
     uint8_t crc = init;
-    size_t i, j;
-    for (i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (j = 0; j < 8; j++) {
-            if ((crc & 0x80) != 0)
-                crc = (uint8_t)((crc << 1) ^ poly);
-            else
-                crc <<= 1;
-        }
-    }
+    for (size_t i = 0; i < len; i++)
+        crc = bitops_crc8_byte(crc, data[i], poly);
     return crc;
 }
 
@@ -27,19 +22,70 @@ uint8_t crc8(const uint8_t *data, size_t len, uint8_t init, uint8_t poly)
 uint16_t crc16(const uint8_t *data, size_t len, uint16_t init, uint16_t poly)
 {
     uint16_t crc = init;
-    size_t i, j;
-    for (i = 0; i < len; i++) {
-        crc ^= (uint16_t)data[i] << 8;
-        for (j = 0; j < 8; j++) {
-            if ((crc & 0x8000) != 0)
-                crc = (uint16_t)((crc << 1) ^ poly);
-            else
-                crc <<= 1;
-        }
-    }
+    for (size_t i = 0; i < len; i++)
+        crc = bitops_crc16_byte(crc, data[i], poly);
     return crc;
 }
 
+/* Single bit error correction for CRC8. The syndrome of a frame, its CRC
+ * XOR the CRC received, only depends on the bits in error, not on the
+ * data or the CRC init value: for each (poly, len) a table maps the
+ * syndrome of every single bit error to its position. Tables are built
+ * on first use and the last CRC8_FIX_TABLES are kept. A syndrome shared
+ * by two positions (frames longer than the polynomial period) marks
+ * them as not correctable. */
+#define CRC8_FIX_TABLES 4
+#define CRC8_FIX_MAX_LEN 30         /* Positions + 1 must fit a byte. */
+#define CRC8_FIX_AMBIGUOUS 0xFF
+
+static struct {
+    bool used;
+    uint8_t poly, len;
+    uint8_t pos[256];               /* Bit position + 1, 0 if none. */
+} Crc8FixTables[CRC8_FIX_TABLES];
+static uint32_t Crc8FixNext;
+
+static const uint8_t *crc8_fix_table(uint8_t poly, size_t len) {
+    for (uint32_t j = 0; j < CRC8_FIX_TABLES; j++) {
+        if (Crc8FixTables[j].used && Crc8FixTables[j].poly == poly &&
+            Crc8FixTables[j].len == len)
+            return Crc8FixTables[j].pos;
+    }
+
+    uint32_t slot = Crc8FixNext++ % CRC8_FIX_TABLES;
+    uint8_t *pos = Crc8FixTables[slot].pos;
+    memset(pos, 0, 256);
+    /* A flipped bit in the last CRC bit gives syndrome 1. Each bit
+     * earlier in the frame multiplies the syndrome by x. */
+    uint32_t s = 1;
+    for (int32_t p = (len + 1) * 8 - 1; p >= 0; p--) {
+        pos[s] = pos[s] ? CRC8_FIX_AMBIGUOUS : p + 1;
+        s = ((s << 1) ^ (poly & -((s >> 7) & 1))) & 0xFF;
+    }
+    Crc8FixTables[slot].used = true;
+    Crc8FixTables[slot].poly = poly;
+    Crc8FixTables[slot].len = len;
+    return pos;
+}
+
+/* 'data' holds 'len' bytes followed by their CRC8 with the specified
+ * 'init' and 'poly', that doesn't match. If the mismatch is the one of a
+ * single flipped bit, of the data or of the CRC, flip it back and return
+ * its position (0 is the most significant bit of data[0]). Otherwise
+ * return -1 and leave the data unchanged. */
+int crc8_fix_single_bit(uint8_t *data, size_t len, uint8_t init, uint8_t poly)
+{
+    if (len == 0 || len > CRC8_FIX_MAX_LEN) return -1;
+    uint8_t syndrome = crc8(data, len, init, poly) ^ data[len];
+    if (syndrome == 0) return -1;
+
+    uint32_t p = crc8_fix_table(poly, len)[syndrome];
+    if (p == 0 || p == CRC8_FIX_AMBIGUOUS) return -1;
+    p--;
+    data[p / 8] ^= 0x80 >> (p % 8);
+    return p;
+}
+
 /* Sum all the specified bytes modulo 256.
  * Initialize the sum with 'init' (usually 0). */
 uint8_t sum_bytes(const uint8_t *data, size_t len, uint8_t init) {
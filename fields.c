@@ -271,6 +271,15 @@ ProtoViewFieldSet *fieldset_new(void) {
     return fs;
 }
 
+/* Find a field in a fieldset by name. Returns NULL if not found. */
+ProtoViewField *fieldset_find(ProtoViewFieldSet *fs, const char *name) {
+    for (uint32_t i = 0; i < fs->numfields; i++) {
+        if (strcmp(fs->fields[i]->name, name) == 0)
+            return fs->fields[i];
+    }
+    return NULL;
+}
+
 /* Append an already allocated field at the end of the specified field set. */
 static void fieldset_add_field(ProtoViewFieldSet *fs, ProtoViewField *field) {
     fs->numfields++;
@@ -0,0 +1,127 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license.
+ *
+ * Engine for declarative protocols. Many TPMS protocols are the same steps
+ * with different constants: find the sync, line decode a fixed number of
+ * bytes, verify a checksum, and extract fields at fixed offsets with a
+ * scale and an offset. Such protocols are described by a ProtoViewProtoDesc
+ * and a few metadata of their ProtoViewDecoder (sync patterns, line code,
+ * min_bits) instead of code, and run by proto_desc_decode().
+ *
+ * The steps are the ones decoders written in C use: the sync comes from
+ * the single pass sync matcher, Manchester goes through the table driven
+ * path of convert_from_line_code(), the checksums through crc.c, and the
+ * fields are read with a bit cursor. */
+
+#include "app.h"
+
+#define PROTO_DESC_MAX_LEN 32   /* Payload bytes. */
+
+/* Return true if the payload 'raw', of 'len' bytes, passes the check. A
+ * CRC8 stored right after the bytes it covers may correct a single bit
+ * error in 'raw', see decoder_fix_crc8(). */
+static bool proto_check(const ProtoViewCheckDesc *c, uint8_t *raw,
+                        uint32_t len, ProtoViewMsgInfo *info)
+{
+    if (c->kind == ProtoCheckNone) return true;
+    if ((uint32_t)c->from + c->len > len) return false;
+
+    uint8_t *data = raw + c->from;
+    uint32_t value;
+    switch (c->kind) {
+    case ProtoCheckCrc8: value = crc8(data, c->len, c->init, c->poly); break;
+    case ProtoCheckCrc16: value = crc16(data, c->len, c->init, c->poly); break;
+    case ProtoCheckSum8: value = sum_bytes(data, c->len, c->init); break;
+    case ProtoCheckXor8: value = xor_bytes(data, c->len, c->init); break;
+    default: return false;
+    }
+
+    if (c->at < 0) return value == 0;
+    if (c->kind == ProtoCheckCrc16) {
+        if ((uint32_t)c->at + 2 > len) return false;
+        return value == ((uint32_t)raw[c->at] << 8 | raw[c->at + 1]);
+    }
+    if ((uint32_t)c->at >= len) return false;
+    if (value == raw[c->at]) return true;
+    return c->kind == ProtoCheckCrc8 && c->at == c->from + c->len &&
+           decoder_fix_crc8(info, data, c->len, c->init, c->poly);
+}
+
+/* Add the fields described by 'fields' to the fieldset. */
+static void proto_add_fields(ProtoViewFieldSet *fs,
+                             const ProtoViewFieldDesc *fields,
+                             const uint8_t *raw, uint32_t len)
+{
+    for (const ProtoViewFieldDesc *f = fields; f && f->name; f++) {
+        if (f->type == FieldTypeBytes) {
+            fieldset_add_bytes(fs, f->name, raw + f->bitpos / 8, f->width / 4);
+            continue;
+        }
+
+        BitReader r;
+        bit_reader_init(&r, raw, len, f->bitpos);
+        uint32_t v = bit_reader_get(&r, f->width);
+        switch (f->type) {
+        case FieldTypeFloat:
+            fieldset_add_float(fs, f->name, (float)v * f->scale + f->offset,
+                               f->digits);
+            break;
+        case FieldTypeSignedInt:
+            fieldset_add_int(fs, f->name, (int64_t)v + (int64_t)f->offset,
+                             f->width);
+            break;
+        case FieldTypeUnsignedInt:
+            fieldset_add_uint(fs, f->name, v, f->width);
+            break;
+        case FieldTypeHex:
+            fieldset_add_hex(fs, f->name, v, f->width);
+            break;
+        case FieldTypeBinary:
+            fieldset_add_bin(fs, f->name, v, f->width);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/* Decode callback of the declarative decoder 'd': same arguments and
+ * return value as ProtoViewDecoder.decode. */
+bool proto_desc_decode(const ProtoViewDecoder *d, uint8_t *bits,
+                       uint32_t numbytes, uint32_t numbits,
+                       ProtoViewMsgInfo *info)
+{
+    const ProtoViewProtoDesc *p = d->desc;
+    if (p->len > PROTO_DESC_MAX_LEN || numbits < d->min_bits) return false;
+
+    uint32_t off = info->sync_off[0];
+    if (off == BITMAP_SEEK_NOT_FOUND) return false;
+    info->start_off = off;
+    off += strlen(d->sync[0]);
+
+    uint8_t raw[PROTO_DESC_MAX_LEN];
+    uint32_t need = p->len * 8;
+    uint32_t decoded;
+    switch (d->line_code) {
+    case LineCodeManchester:
+        if (p->flags & PROTO_DESC_MANCHESTER_10_IS_0)
+            decoded = convert_from_line_code(raw, p->len, bits, numbytes,
+                                             off, "10", "01");
+        else
+            decoded = convert_from_line_code(raw, p->len, bits, numbytes,
+                                             off, "01", "10");
+        break;
+    case LineCodeDiffManchester:
+        decoded = diff_manchester_decode(raw, p->len, bits, numbytes, off,
+                                         need);
+        break;
+    default:
+        return false;
+    }
+    if (decoded < need) return false;
+    if (!proto_check(&p->check, raw, p->len, info)) return false;
+
+    info->pulses_count = (off + need * 2) - info->start_off;
+    proto_add_fields(info->fieldset, p->fields, raw, p->len);
+    return true;
+}
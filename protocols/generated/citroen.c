@@ -0,0 +1,54 @@
+/* Generated by tools/protogen.py from protocols/specs/citroen.spec.
+ * Do not edit: change the spec and run the generator.
+ *
+ * Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license.
+ *
+ * Citroen TPMS. Usually 443.92 Mhz FSK.
+ *
+ * Preamble of ~14 high/low 52 us pulses
+ * Sync of high 100us pulse then 50us low
+ * Then Manchester bits, 10 bytes total.
+ * Simple XOR checksum of bytes 1-9: the meaning of the first byte is
+ * unknown and it is not displayed. Byte 8 may be the battery, it's not
+ * clear.
+ *
+ * Rarely seen at 315 MHz: interpreted by the generic engine to save flash. */
+
+#include "../../app.h"
+#include "decoders.h"
+
+static const char *sync_patterns[] = {"10101010101010110", NULL};
+
+static const ProtoViewFieldDesc fields[] = {
+    {"Tire ID", FieldTypeBytes, 8, 32, 0, 1.0f, 0.0f},
+    {"Pressure kpa", FieldTypeFloat, 48, 8, 2, 1.364f, 0.0f},
+    {"Temperature C", FieldTypeSignedInt, 56, 8, 0, 1.0f, -50.0f},
+    {"Repeat", FieldTypeUnsignedInt, 44, 4, 0, 1.0f, 0.0f},
+    {"Battery", FieldTypeUnsignedInt, 64, 8, 0, 1.0f, 0.0f},
+    {NULL, 0, 0, 0, 0, 0, 0}
+};
+
+static const ProtoViewProtoDesc desc = {
+    .len = 10,
+    .check = {ProtoCheckXor8, 1, 9, -1, 0x00, 0x00},
+    .fields = fields,
+};
+
+ProtoViewDecoder CitroenTPMSDecoder = {
+    .name = "Citroen TPMS",
+    .decode = NULL,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 52,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 97,
+    .max_bits = 177,
+    .check_bits = 6,
+    .desc = &desc
+};
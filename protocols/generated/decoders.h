@@ -0,0 +1,29 @@
+/* Generated by tools/protogen.py from the protocols/specs files.
+ * Do not edit: change the specs and run the generator.
+ *
+ * Declarations of the generated decoders and of the CRC tables
+ * they share, and their entries of the Decoders[] table of
+ * signal.c: GENERATED_DECODERS_AT_<n> lists the ones placed after
+ * the first n hand-written decoders there. */
+
+#pragma once
+
+extern ProtoViewDecoder CitroenTPMSDecoder;
+extern ProtoViewDecoder Elantra2012TPMSDecoder;
+extern ProtoViewDecoder HyundaiKiaTPMSDecoder;
+extern ProtoViewDecoder PorscheTPMSDecoder;
+extern ProtoViewDecoder SchraderTPMSDecoder;
+
+extern const uint16_t CrcTable16Poly1021[256];
+extern const uint8_t CrcTable8Poly07[256];
+
+#define GENERATED_DECODERS_AT_0
+#define GENERATED_DECODERS_AT_1 &Elantra2012TPMSDecoder,
+#define GENERATED_DECODERS_AT_2
+#define GENERATED_DECODERS_AT_3 &PorscheTPMSDecoder,
+#define GENERATED_DECODERS_AT_4
+#define GENERATED_DECODERS_AT_5
+#define GENERATED_DECODERS_AT_6 &SchraderTPMSDecoder,
+#define GENERATED_DECODERS_AT_7 &CitroenTPMSDecoder,
+#define GENERATED_DECODERS_AT_8 &HyundaiKiaTPMSDecoder,
+#define GENERATED_DECODERS_AT_9
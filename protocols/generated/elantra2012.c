@@ -0,0 +1,71 @@
+/* Generated by tools/protogen.py from protocols/specs/elantra2012.spec.
+ * Do not edit: change the spec and run the generator.
+ *
+ * Hyundai Elantra 2012 / Honda Civic TPMS (TRW sensor, FCC ID GQ4-44T).
+ * FSK modulation, Manchester encoding, 315 MHz (US) / 433 MHz (EU).
+ *
+ * Preamble: 0x7155 (16 bits: 0111000101010101)
+ * Data: 64 bits Manchester encoded -> 8 bytes.
+ *
+ * Byte layout: PP TT II II II II FF CC
+ *   PP: pressure raw (kPa = raw + 60)
+ *   TT: temperature raw (C = raw - 50)
+ *   II: 32-bit sensor ID
+ *   FF: flags (storage, battery, trigger)
+ *   CC: CRC-8, poly 0x07, init 0x00
+ *
+ * Protocol documentation derived from rtl_433 project (GPL-2.0).
+ * This is an independent implementation for the Flipper Zero platform. */
+
+#include "../../app.h"
+#include "decoders.h"
+
+static const char *sync_patterns[] = {"0111000101010101", NULL};
+
+static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
+                   ProtoViewMsgInfo *info)
+{
+    if (numbits < 144) return false;
+
+    uint32_t off = info->sync_off[0];
+    if (off == BITMAP_SEEK_NOT_FOUND) return false;
+    info->start_off = off;
+    off += 16;
+
+    uint8_t raw[8];
+    uint32_t decoded = convert_from_line_code(
+        raw, sizeof(raw), bits, numbytes, off, "01", "10");
+    if (decoded < 64) return false;
+
+    uint8_t check = 0x00;
+    for (int j = 0; j <= 6; j++)
+        check = CrcTable8Poly07[check ^ raw[j]];
+    if (check != raw[7] &&
+        !decoder_fix_crc8(info, raw, 7, 0x00, 0x07)) return false;
+
+    info->pulses_count = (off + 128) - info->start_off;
+    fieldset_add_bytes(info->fieldset, "Tire ID", raw + 2, 8);
+    fieldset_add_float(info->fieldset, "Pressure kpa",
+        (float)raw[0] + 60.0f, 1);
+    fieldset_add_int(info->fieldset, "Temperature C", (int)raw[1] - 50, 8);
+    return true;
+}
+
+ProtoViewDecoder Elantra2012TPMSDecoder = {
+    .name = "Elantra2012 TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 50,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 144,
+    .max_bits = 144,
+    .check_bits = 8,
+    .crc_fix = true
+};
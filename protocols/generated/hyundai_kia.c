@@ -0,0 +1,72 @@
+/* Generated by tools/protogen.py from protocols/specs/hyundai_kia.spec.
+ * Do not edit: change the spec and run the generator.
+ *
+ * Hyundai / Kia TPMS (Continental/VDO sensors).
+ * Common on US-market Hyundai and Kia vehicles at 315 MHz.
+ * Also found at 433.92 MHz on European models.
+ *
+ * Modulation: FSK, ~52us short pulse.
+ * Preamble: alternating 010101...
+ * Sync: 0110
+ * Encoding: Manchester (01 = 0, 10 = 1)
+ * Data: 10 bytes total.
+ *
+ * Byte layout:
+ *   Byte 0:    Message type / status flags
+ *   Bytes 1-4: 32-bit Sensor ID
+ *   Byte 5:    Battery / status
+ *   Byte 6:    Pressure raw (pressure_kPa = raw * 2.5)
+ *   Byte 7:    Temperature raw (temp_C = raw - 50)
+ *   Byte 8:    Spare / flags
+ *   Byte 9:    CRC-8 (XOR of bytes 0-8) */
+
+#include "../../app.h"
+#include "decoders.h"
+
+static const char *sync_patterns[] = {"0101010101010110", NULL};
+
+static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
+                   ProtoViewMsgInfo *info)
+{
+    if (numbits < 176) return false;
+
+    uint32_t off = info->sync_off[0];
+    if (off == BITMAP_SEEK_NOT_FOUND) return false;
+    info->start_off = off;
+    off += 16;
+
+    uint8_t raw[10];
+    uint32_t decoded = convert_from_line_code(
+        raw, sizeof(raw), bits, numbytes, off, "01", "10");
+    if (decoded < 80) return false;
+
+    uint8_t check = raw[0] ^ raw[1] ^ raw[2] ^ raw[3] ^ raw[4] ^ raw[5] ^
+        raw[6] ^ raw[7] ^ raw[8];
+    if (check != raw[9]) return false;
+
+    info->pulses_count = (off + 160) - info->start_off;
+    fieldset_add_bytes(info->fieldset, "Tire ID", raw + 1, 8);
+    fieldset_add_float(info->fieldset, "Pressure kpa",
+        (float)raw[6] * 2.5f, 2);
+    fieldset_add_int(info->fieldset, "Temperature C", (int)raw[7] - 50, 8);
+    fieldset_add_uint(info->fieldset, "Battery", raw[5] & 0x7f, 7);
+    fieldset_add_hex(info->fieldset, "Flags", raw[0], 8);
+    return true;
+}
+
+ProtoViewDecoder HyundaiKiaTPMSDecoder = {
+    .name = "Hyundai/Kia TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 52,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 176,
+    .max_bits = 176,
+    .check_bits = 6
+};
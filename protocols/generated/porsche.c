@@ -0,0 +1,67 @@
+/* Generated by tools/protogen.py from protocols/specs/porsche.spec.
+ * Do not edit: change the spec and run the generator.
+ *
+ * Porsche Boxster/Cayman (Typ 987) TPMS decoder.
+ * FSK modulation, differential Manchester encoding, 315 MHz (US) / 433 MHz (EU).
+ *
+ * Preamble: alternating 1100 pairs ending in 1010 (~30 bits).
+ * Data: 80 bits (10 bytes) differential Manchester encoded.
+ *
+ *   Bytes 0-3: 32-bit sensor ID
+ *   Byte 4:    Pressure raw (kPa = raw * 5 / 2 - 100)
+ *   Byte 5:    Temperature raw (C = raw - 40)
+ *   Bytes 6-7: Status flags
+ *   Bytes 8-9: CRC-16, poly 0x1021, init 0xFFFF
+ *
+ * Protocol documentation derived from rtl_433 project (GPL-2.0).
+ * This is an independent implementation for the Flipper Zero platform. */
+
+#include "../../app.h"
+#include "decoders.h"
+
+static const char *sync_patterns[] = {"110011001010", NULL};
+
+static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
+                   ProtoViewMsgInfo *info)
+{
+    if (numbits < 180) return false;
+
+    uint32_t off = info->sync_off[0];
+    if (off == BITMAP_SEEK_NOT_FOUND) return false;
+    info->start_off = off;
+    off += 12;
+
+    uint8_t raw[10];
+    uint32_t decoded = diff_manchester_decode(
+        raw, sizeof(raw), bits, numbytes, off, 80);
+    if (decoded < 80) return false;
+
+    uint16_t check = 0xffff;
+    for (int j = 0; j <= 9; j++)
+        check = (check << 8) ^ CrcTable16Poly1021[(check >> 8) ^ raw[j]];
+    if (check != 0) return false;
+
+    info->pulses_count = (off + 160) - info->start_off;
+    fieldset_add_bytes(info->fieldset, "Tire ID", raw, 8);
+    fieldset_add_float(info->fieldset, "Pressure kpa",
+        (float)raw[4] * 2.5f - 100.0f, 1);
+    fieldset_add_int(info->fieldset, "Temperature C", (int)raw[5] - 40, 8);
+    return true;
+}
+
+ProtoViewDecoder PorscheTPMSDecoder = {
+    .name = "Porsche TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeDiffManchester,
+    .symbol_us = 52,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 180,
+    .max_bits = 180,
+    .check_bits = 16
+};
@@ -0,0 +1,73 @@
+/* Generated by tools/protogen.py from protocols/specs/schrader.spec.
+ * Do not edit: change the spec and run the generator.
+ *
+ * Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license.
+ *
+ * Schrader TPMS. Usually 443.92 Mhz OOK, 120us pulse len.
+ *
+ * 500us high pulse + Preamble + Manchester coded bits where:
+ * 1 = 10
+ * 0 = 01
+ *
+ * 60 bits of data total (first 4 nibbles is the preamble, 0xF).
+ * Decoding starts after the long pulse and the first 3 bits of sync, so
+ * that the first byte of data has the sync nibble 0011 = 0x3: the nibble
+ * is set back to 0xF for the checksum.
+ *
+ * Used in FIAT-Chrysler, Mercedes, ... */
+
+#include "../../app.h"
+#include "decoders.h"
+
+static const char *sync_patterns[] = {"111101010101011010", NULL};
+
+static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
+                   ProtoViewMsgInfo *info)
+{
+    if (numbits < 64) return false;
+
+    uint32_t off = info->sync_off[0];
+    if (off == BITMAP_SEEK_NOT_FOUND) return false;
+    info->start_off = off;
+    off += 10;
+
+    uint8_t raw[8];
+    uint32_t decoded = convert_from_line_code(
+        raw, sizeof(raw), bits, numbytes, off, "01", "10");
+    if (decoded < 64) return false;
+
+    raw[0] |= 0xf0;
+    uint8_t check = 0xf0;
+    for (int j = 0; j <= 6; j++)
+        check = CrcTable8Poly07[check ^ raw[j]];
+    if (check != raw[7] &&
+        !(decoder_fix_crc8(info, raw, 7, 0xf0, 0x07) &&
+          (raw[0] & 0xf0) == 0xf0)) return false;
+
+    info->pulses_count = (off + 128) - info->start_off;
+    const uint8_t field0[4] = {raw[1] & 0x07, raw[2], raw[3], raw[4]};
+    fieldset_add_bytes(info->fieldset, "Tire ID", field0, 8);
+    fieldset_add_float(info->fieldset, "Pressure kpa",
+        (float)raw[5] * 2.5f, 2);
+    fieldset_add_int(info->fieldset, "Temperature C", (int)raw[6] - 50, 8);
+    return true;
+}
+
+ProtoViewDecoder SchraderTPMSDecoder = {
+    .name = "Schrader TPMS",
+    .decode = decode,
+    .get_fields = NULL,
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_OOK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 120,
+    .symbol_min_us = 85,
+    .symbol_max_us = 170,
+    .min_bits = 64,
+    .max_bits = 148,
+    .check_bits = 8,
+    .crc_fix = true
+};
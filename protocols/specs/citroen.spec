@@ -0,0 +1,31 @@
+# Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+# See the LICENSE file for information about the license.
+#
+# Citroen TPMS. Usually 443.92 Mhz FSK.
+#
+# Preamble of ~14 high/low 52 us pulses
+# Sync of high 100us pulse then 50us low
+# Then Manchester bits, 10 bytes total.
+# Simple XOR checksum of bytes 1-9: the meaning of the first byte is
+# unknown and it is not displayed. Byte 8 may be the battery, it's not
+# clear.
+#
+# Rarely seen at 315 MHz: interpreted by the generic engine to save flash.
+
+decoder         CitroenTPMSDecoder
+slot            7
+name            "Citroen TPMS"
+engine          table
+sync            10101010101010110
+sync_max_errors 1
+modulation      fsk
+line_code       manchester
+symbol_us       52 35 75
+bits            97 177
+bytes           10
+check           xor8 1-9 zero
+field           "Tire ID" bytes 8 32
+field           "Pressure kpa" float 48 8 scale=1.364 digits=2
+field           "Temperature C" int 56 8 offset=-50
+field           "Repeat" uint 44 4
+field           "Battery" uint 64 8
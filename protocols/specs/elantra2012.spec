@@ -0,0 +1,31 @@
+# Hyundai Elantra 2012 / Honda Civic TPMS (TRW sensor, FCC ID GQ4-44T).
+# FSK modulation, Manchester encoding, 315 MHz (US) / 433 MHz (EU).
+#
+# Preamble: 0x7155 (16 bits: 0111000101010101)
+# Data: 64 bits Manchester encoded -> 8 bytes.
+#
+# Byte layout: PP TT II II II II FF CC
+#   PP: pressure raw (kPa = raw + 60)
+#   TT: temperature raw (C = raw - 50)
+#   II: 32-bit sensor ID
+#   FF: flags (storage, battery, trigger)
+#   CC: CRC-8, poly 0x07, init 0x00
+#
+# Protocol documentation derived from rtl_433 project (GPL-2.0).
+# This is an independent implementation for the Flipper Zero platform.
+
+decoder         Elantra2012TPMSDecoder
+slot            1
+name            "Elantra2012 TPMS"
+sync            0111000101010101
+sync_max_errors 1
+allow_inverted  yes
+modulation      fsk
+line_code       manchester
+symbol_us       50 35 75
+bits            144 144
+bytes           8
+check           crc8 0-6 7 poly=0x07 init=0x00
+field           "Tire ID" bytes 16 32
+field           "Pressure kpa" float 0 8 offset=60 digits=1
+field           "Temperature C" int 8 8 offset=-50
@@ -0,0 +1,35 @@
+# Hyundai / Kia TPMS (Continental/VDO sensors).
+# Common on US-market Hyundai and Kia vehicles at 315 MHz.
+# Also found at 433.92 MHz on European models.
+#
+# Modulation: FSK, ~52us short pulse.
+# Preamble: alternating 010101...
+# Sync: 0110
+# Encoding: Manchester (01 = 0, 10 = 1)
+# Data: 10 bytes total.
+#
+# Byte layout:
+#   Byte 0:    Message type / status flags
+#   Bytes 1-4: 32-bit Sensor ID
+#   Byte 5:    Battery / status
+#   Byte 6:    Pressure raw (pressure_kPa = raw * 2.5)
+#   Byte 7:    Temperature raw (temp_C = raw - 50)
+#   Byte 8:    Spare / flags
+#   Byte 9:    CRC-8 (XOR of bytes 0-8)
+
+decoder         HyundaiKiaTPMSDecoder
+slot            8
+name            "Hyundai/Kia TPMS"
+sync            0101010101010110
+sync_max_errors 1
+modulation      fsk
+line_code       manchester
+symbol_us       52 35 75
+bits            176 176
+bytes           10
+check           xor8 0-8 9
+field           "Tire ID" bytes 8 32
+field           "Pressure kpa" float 48 8 scale=2.5 digits=2
+field           "Temperature C" int 56 8 offset=-50
+field           "Battery" uint 41 7
+field           "Flags" hex 0 8
@@ -0,0 +1,29 @@
+# Porsche Boxster/Cayman (Typ 987) TPMS decoder.
+# FSK modulation, differential Manchester encoding, 315 MHz (US) / 433 MHz (EU).
+#
+# Preamble: alternating 1100 pairs ending in 1010 (~30 bits).
+# Data: 80 bits (10 bytes) differential Manchester encoded.
+#
+#   Bytes 0-3: 32-bit sensor ID
+#   Byte 4:    Pressure raw (kPa = raw * 5 / 2 - 100)
+#   Byte 5:    Temperature raw (C = raw - 40)
+#   Bytes 6-7: Status flags
+#   Bytes 8-9: CRC-16, poly 0x1021, init 0xFFFF
+#
+# Protocol documentation derived from rtl_433 project (GPL-2.0).
+# This is an independent implementation for the Flipper Zero platform.
+
+decoder         PorscheTPMSDecoder
+slot            3
+name            "Porsche TPMS"
+sync            110011001010
+allow_inverted  yes
+modulation      fsk
+line_code       diff-manchester
+symbol_us       52 35 75
+bits            180 180
+bytes           10
+check           crc16 0-9 zero poly=0x1021 init=0xFFFF
+field           "Tire ID" bytes 0 32
+field           "Pressure kpa" float 32 8 scale=2.5 offset=-100 digits=1
+field           "Temperature C" int 40 8 offset=-40
@@ -0,0 +1,32 @@
+# Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+# See the LICENSE file for information about the license.
+#
+# Schrader TPMS. Usually 443.92 Mhz OOK, 120us pulse len.
+#
+# 500us high pulse + Preamble + Manchester coded bits where:
+# 1 = 10
+# 0 = 01
+#
+# 60 bits of data total (first 4 nibbles is the preamble, 0xF).
+# Decoding starts after the long pulse and the first 3 bits of sync, so
+# that the first byte of data has the sync nibble 0011 = 0x3: the nibble
+# is set back to 0xF for the checksum.
+#
+# Used in FIAT-Chrysler, Mercedes, ...
+
+decoder         SchraderTPMSDecoder
+slot            6
+name            "Schrader TPMS"
+sync            111101010101011010
+skip            10
+sync_max_errors 1
+modulation      ook
+line_code       manchester
+symbol_us       120 85 170
+bits            64 148
+bytes           8
+set             0 0xf0
+check           crc8 0-6 7 poly=0x07 init=0xf0
+field           "Tire ID" bytes 13 27
+field           "Pressure kpa" float 40 8 scale=2.5 digits=2
+field           "Temperature C" int 48 8 offset=-50
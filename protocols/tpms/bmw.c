@@ -16,14 +16,15 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {"1010101001011001", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
                    ProtoViewMsgInfo *info)
 {
     if (numbits < 16 + 64 * 2) return false;
 
     /* Preamble: 0xAA59 = 1010101001011001 */
-    uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits,
-                                    "1010101001011001");
+    uint32_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
 
     info->start_off = off;
@@ -45,7 +46,8 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
     uint8_t crc_len = msg_len - 1;
 
     /* CRC-8: poly 0x2F, init 0xAA. */
-    if (crc8(raw, crc_len, 0xAA, 0x2F) != raw[crc_len]) return false;
+    if (crc8(raw, crc_len, 0xAA, 0x2F) != raw[crc_len] &&
+        !decoder_fix_crc8(info, raw, crc_len, 0xAA, 0x2F)) return false;
 
     /* Extract fields. */
     uint8_t tire_id[4];
@@ -69,5 +71,17 @@ ProtoViewDecoder BMWTPMSDecoder = {
     .name = "BMW/Audi TPMS",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 25,
+    .symbol_min_us = 18,
+    .symbol_max_us = 36,
+    .min_bits = 144,
+    .max_bits = 192,
+    .check_bits = 8,
+    .crc_fix = true
 };
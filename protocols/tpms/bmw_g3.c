@@ -15,14 +15,15 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {"1100110011001101", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
                    ProtoViewMsgInfo *info)
 {
     if (numbits < 16 + 88 * 2) return false;
 
     /* Preamble: 0xCCCD = 1100110011001101 */
-    uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits,
-                                    "1100110011001101");
+    uint32_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
 
     info->start_off = off;
@@ -66,5 +67,16 @@ ProtoViewDecoder BMWGen3TPMSDecoder = {
     .name = "BMW Gen2/3 TPMS",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeDiffManchester,
+    .symbol_us = 25,
+    .symbol_min_us = 18,
+    .symbol_max_us = 36,
+    .min_bits = 192,
+    .max_bits = 192,
+    .check_bits = 16
 };
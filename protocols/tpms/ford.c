@@ -13,15 +13,16 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {"010101010101" "0110", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo *info) {
 
-    const char *sync_pattern = "010101010101" "0110";
     uint8_t sync_len = 12+4; /* We just use 12 preamble symbols + sync. */
     if (numbits-sync_len < 8*8) return false;
 
-    uint64_t off = bitmap_seek_bits(bits,numbytes,0,numbits,sync_pattern);
+    uint64_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
-    FURI_LOG_D(TAG, "Ford TPMS preamble+sync found");
+    LOG_D("Ford TPMS preamble+sync found");
 
     info->start_off = off;
     off += sync_len; /* Skip preamble and sync. */
@@ -30,7 +31,7 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoView
     uint32_t decoded =
         convert_from_line_code(raw,sizeof(raw),bits,numbytes,off,
             "01","10"); /* Manchester. */
-    FURI_LOG_D(TAG, "Ford TPMS decoded bits: %lu", decoded);
+    LOG_D("Ford TPMS decoded bits: %lu", decoded);
 
     if (decoded < 8*8) return false; /* Require the full 8 bytes. */
 
@@ -41,7 +42,11 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     info->pulses_count = (off+8*8*2) - info->start_off;
 
-    float psi = 0.25 * (((raw[6]&0x20)<<3)|raw[4]);
+    /* Pressure is 9 bits: bit 5 of byte 6 (bit 50 of the message) is the
+     * most significant one, byte 4 the rest. */
+    BitReader r;
+    bit_reader_init(&r,raw,sizeof(raw),6*8+2);
+    float psi = 0.25 * ((bit_reader_get(&r,1)<<8)|raw[4]);
 
     /* Temperature apperas to be valid only if the most significant
      * bit of the value is not set. Otherwise its meaning is unknown.
@@ -62,5 +67,15 @@ ProtoViewDecoder FordTPMSDecoder = {
     .name = "Ford TPMS",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 52,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 80,
+    .max_bits = 144,
+    .check_bits = 6
 };
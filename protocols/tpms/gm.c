@@ -22,6 +22,15 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {
+    "101010101010101010101010"
+    "101010101010101010101010",
+    NULL
+};
+
+/* Flipped bits accepted in the preamble. */
+#define GM_PREAMBLE_MAX_ERRORS 3
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
                    ProtoViewMsgInfo *info)
 {
@@ -30,25 +39,29 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
 
     /* Preamble: 48 bits of zeros = 48 Manchester symbols "10" = 96 raw bits
      * of alternating 1010...  We search for a chunk of this pattern. */
-    const char *preamble = "101010101010101010101010"
-                           "101010101010101010101010";
-    uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, preamble);
+    uint32_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
 
     info->start_off = off;
 
-    /* Manchester zero-bit decode from start of preamble: 10=0, 01=1. */
+    /* First 6 bytes (48 bits) should be all zeros (preamble), that is
+     * 96 raw bits of 1010... Like the sync search, accept a few flipped
+     * bits: the checksum still protects the data. */
+    BitReader r;
+    bit_reader_init(&r, bits, numbytes, off);
+    uint32_t errors = 0;
+    for (int i = 0; i < 3; i++)
+        errors += bitops_popcount32(bit_reader_get(&r, 32) ^ 0xAAAAAAAA);
+    if (errors > GM_PREAMBLE_MAX_ERRORS) return false;
+    off += 96;
+
+    /* Manchester zero-bit decode after the preamble: 10=0, 01=1. */
     uint8_t raw[17];
     memset(raw, 0, sizeof(raw));
     uint32_t decoded = convert_from_line_code(
-        raw, sizeof(raw), bits, numbytes, off, "10", "01");
-
-    if (decoded < 130) return false;
+        raw + 6, sizeof(raw) - 6, bits, numbytes, off, "10", "01");
 
-    /* First 6 bytes (48 bits) should be all zeros (preamble). */
-    for (int i = 0; i < 6; i++) {
-        if (raw[i] != 0x00) return false;
-    }
+    if (decoded < 130 - 48) return false;
 
     /* Checksum: sum of bytes 6-15 mod 256. */
     uint8_t sum = sum_bytes(raw + 6, 10, 0);
@@ -80,5 +93,15 @@ ProtoViewDecoder GMTPMSDecoder = {
     .name = "GM TPMS",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .sync_max_errors = GM_PREAMBLE_MAX_ERRORS,
+    .mod_class = MOD_CLASS_OOK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 120,
+    .symbol_min_us = 85,
+    .symbol_max_us = 170,
+    .min_bits = 212,
+    .max_bits = 272,
+    .check_bits = 6
 };
@@ -26,6 +26,8 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {"111110", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
                    ProtoViewMsgInfo *info)
 {
@@ -33,10 +35,10 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
     if (numbits < 6 + 66 * 2) return false;
 
     /* Search for preamble: 111110 (five ones + first half of reference). */
-    uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits, "111110");
+    uint32_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
 
-    FURI_LOG_D(TAG, "PMV-107J preamble found at %lu", off);
+    LOG_D("PMV-107J preamble found at %lu", off);
     info->start_off = off;
     off += 6; /* Skip preamble, start at second half of reference clock. */
 
@@ -46,40 +48,43 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
     uint32_t decoded = diff_manchester_decode(
         decoded_buf, sizeof(decoded_buf), bits, numbytes, off, 70);
 
-    FURI_LOG_D(TAG, "PMV-107J diff manchester decoded %lu bits", decoded);
+    LOG_D("PMV-107J diff manchester decoded %lu bits", decoded);
     if (decoded < 66) return false;
 
     /* Realign: first 2 decoded bits go to b[0], next 64 bits to b[1..8].
      * This matches the rtl_433 realignment. */
     uint8_t b[9];
-    memset(b, 0, sizeof(b));
-    b[0] = (bitmap_get(decoded_buf, sizeof(decoded_buf), 0) ? 0x02 : 0) |
-           (bitmap_get(decoded_buf, sizeof(decoded_buf), 1) ? 0x01 : 0);
-    bitmap_copy(b + 1, 8, 0, decoded_buf, sizeof(decoded_buf), 2, 64);
+    BitReader r;
+    bit_reader_init(&r, decoded_buf, sizeof(decoded_buf), 0);
+    b[0] = bit_reader_get(&r, 2);
+    for (int j = 1; j < 9; j++) b[j] = bit_reader_get(&r, 8);
 
     /* CRC-8 check: poly 0x13, init 0x00 over bytes 0-7, must equal byte 8. */
     uint8_t crc = crc8(b, 8, 0x00, 0x13);
-    if (crc != b[8]) {
-        FURI_LOG_D(TAG, "PMV-107J CRC mismatch: calc=%02X got=%02X", crc, b[8]);
+    if (crc != b[8] && !decoder_fix_crc8(info, b, 8, 0x00, 0x13)) {
+        LOG_D("PMV-107J CRC mismatch: calc=%02X got=%02X", crc, b[8]);
         return false;
     }
 
     /* Pressure integrity: b[5] and b[6] XOR must be 0xFF. */
     if ((b[5] ^ b[6]) != 0xFF) {
-        FURI_LOG_D(TAG, "PMV-107J pressure check failed: %02X ^ %02X != FF",
+        LOG_D("PMV-107J pressure check failed: %02X ^ %02X != FF",
                    b[5], b[6]);
         return false;
     }
 
-    /* Extract fields. */
-    uint8_t tire_id[4];
-    tire_id[0] = (b[0] << 6) | (b[1] >> 2);
-    tire_id[1] = (b[1] << 6) | (b[2] >> 2);
-    tire_id[2] = (b[2] << 6) | (b[3] >> 2);
-    tire_id[3] = (b[3] << 6) | (b[4] >> 2);
-    /* 28-bit ID is in tire_id[0..3] with lower 4 bits of tire_id[3] unused.
+    /* Extract fields. The ID bytes are the first 32 decoded bits.
+     * 28-bit ID is in tire_id[0..3] with lower 4 bits of tire_id[3] unused.
      * Actually the ID is: b[0]<<26 | b[1]<<18 | b[2]<<10 | b[3]<<2 | b[4]>>6
-     * For our fieldset, store the 4 raw bytes. */
+     * For our fieldset, store the 4 raw bytes, taken from b[] so that a
+     * bit corrected by the CRC is corrected in the ID too. */
+    uint8_t tire_id[4];
+    BitWriter w;
+    bit_writer_init(&w, tire_id, sizeof(tire_id), 0);
+    bit_writer_put(&w, b[0], 2);
+    for (int j = 1; j < 4; j++) bit_writer_put(&w, b[j], 8);
+    bit_writer_put(&w, b[4] >> 2, 6);
+    bit_writer_flush(&w);
 
     float pressure_kpa = (b[5] - 40.0f) * 2.48f;
     int temp_c = (int)b[7] - 40;
@@ -96,5 +101,16 @@ ProtoViewDecoder PMV107JTPMSDecoder = {
     .name = "Toyota PMV-107J",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeDiffManchester,
+    .symbol_us = 100,
+    .symbol_min_us = 70,
+    .symbol_max_us = 140,
+    .min_bits = 138,
+    .max_bits = 138,
+    .check_bits = 14, /* CRC-8, and the pressure complement. */
+    .crc_fix = true
 };
@@ -25,19 +25,22 @@ static const char *test_vector =
     "0101010101010101"  // Two FF bytes (usually). Unknown.
     "0110010101010101"; // CRC8 with (poly 7, initialization 0).
 
+static const char *sync_patterns[] = {"01010101010101010110", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo *info) {
 
     if (USE_TEST_VECTOR) { /* Test vector to check that decoding works. */
         bitmap_set_pattern(bits,numbytes,0,test_vector);
         numbits = strlen(test_vector);
+        info->sync_off[0] =
+            bitmap_seek_bits(bits,numbytes,0,numbits,sync_patterns[0]);
     }
 
     if (numbits-12 < 9*8) return false;
 
-    const char *sync_pattern = "01010101010101010110";
-    uint64_t off = bitmap_seek_bits(bits,numbytes,0,numbits,sync_pattern);
+    uint64_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
-    FURI_LOG_D(TAG, "Renault TPMS preamble+sync found");
+    LOG_D("Renault TPMS preamble+sync found");
 
     info->start_off = off;
     off += 20; /* Skip preamble. */
@@ -46,10 +49,12 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoView
     uint32_t decoded =
         convert_from_line_code(raw,sizeof(raw),bits,numbytes,off,
             "01","10"); /* Manchester. */
-    FURI_LOG_D(TAG, "Renault TPMS decoded bits: %lu", decoded);
+    LOG_D("Renault TPMS decoded bits: %lu", decoded);
 
     if (decoded < 8*9) return false; /* Require the full 9 bytes. */
-    if (crc8(raw,8,0,7) != raw[8]) return false; /* Require sane CRC. */
+    /* Require sane CRC. */
+    if (crc8(raw,8,0,7) != raw[8] && !decoder_fix_crc8(info,raw,8,0,7))
+        return false;
 
     info->pulses_count = (off+8*9*2) - info->start_off;
 
@@ -119,5 +124,17 @@ ProtoViewDecoder RenaultTPMSDecoder = {
     .name = "Renault TPMS",
     .decode = decode,
     .get_fields = get_fields,
-    .build_message = build_message
+    .build_message = build_message,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 52,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 84,
+    .max_bits = 156,
+    .check_bits = 8,
+    .crc_fix = true
 };
@@ -18,15 +18,16 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {"010101010101" "01100101", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo *info) {
 
-    const char *sync_pattern = "010101010101" "01100101";
     uint8_t sync_len = 12+8; /* We just use 12 preamble symbols + sync. */
     if (numbits-sync_len+8 < 8*10) return false;
 
-    uint64_t off = bitmap_seek_bits(bits,numbytes,0,numbits,sync_pattern);
+    uint64_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
-    FURI_LOG_D(TAG, "Schrader EG53MA4 TPMS preamble+sync found");
+    LOG_D("Schrader EG53MA4 TPMS preamble+sync found");
 
     info->start_off = off;
     off += sync_len-8; /* Skip preamble, not sync that is part of the data. */
@@ -35,7 +36,7 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoView
     uint32_t decoded =
         convert_from_line_code(raw,sizeof(raw),bits,numbytes,off,
             "01","10"); /* Manchester code. */
-    FURI_LOG_D(TAG, "Schrader EG53MA4 TPMS decoded bits: %lu", decoded);
+    LOG_D("Schrader EG53MA4 TPMS decoded bits: %lu", decoded);
 
     if (decoded < 10*8) return false; /* Require the full 10 bytes. */
 
@@ -63,5 +64,15 @@ ProtoViewDecoder SchraderEG53MA4TPMSDecoder = {
     .name = "Schrader EG53MA4 TPMS",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .sync_max_errors = 1,
+    .mod_class = MOD_CLASS_OOK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 100,
+    .symbol_min_us = 70,
+    .symbol_max_us = 150,
+    .min_bits = 92,
+    .max_bits = 180,
+    .check_bits = 6
 };
@@ -16,6 +16,8 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {"010101011110", NULL};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
                    ProtoViewMsgInfo *info)
 {
@@ -23,8 +25,7 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
 
     /* Preamble ends with ...01010101 1110.
      * Search for the tail of the preamble. */
-    uint32_t off = bitmap_seek_bits(bits, numbytes, 0, numbits,
-                                    "010101011110");
+    uint32_t off = info->sync_off[0];
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
 
     info->start_off = off;
@@ -47,12 +48,12 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits,
      * Bits 3-26:  sensor ID (24 bits)
      * Bits 27-36: pressure raw (10 bits)
      * Bits 37-38: check (2 bits) */
+    BitReader r;
+    bit_reader_init(&r, raw, sizeof(raw), 3);
     uint8_t tire_id[3];
-    tire_id[0] = ((raw[0] & 0x1F) << 3) | (raw[1] >> 5);
-    tire_id[1] = (raw[1] << 3) | (raw[2] >> 5);
-    tire_id[2] = (raw[2] << 3) | (raw[3] >> 5);
+    for (int j = 0; j < 3; j++) tire_id[j] = bit_reader_get(&r, 8);
 
-    uint16_t pressure_raw = ((uint16_t)(raw[3] & 0x1F) << 5) | (raw[4] >> 3);
+    uint16_t pressure_raw = bit_reader_get(&r, 10);
     float pressure_psi = (float)pressure_raw * 0.2f;
 
     /* Basic sanity: pressure should be in reasonable range. */
@@ -69,5 +70,13 @@ ProtoViewDecoder SchraderSMD3MA4TPMSDecoder = {
     .name = "Schrader SMD3MA4",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .mod_class = MOD_CLASS_OOK,
+    .line_code = LineCodeManchester,
+    .symbol_us = 120,
+    .symbol_min_us = 85,
+    .symbol_max_us = 170,
+    .min_bits = 90,
+    .max_bits = 100
 };
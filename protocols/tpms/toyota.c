@@ -27,40 +27,42 @@
 
 #include "../../app.h"
 
+static const char *sync_patterns[] = {
+    "00111100",
+    "001111100",
+    "00111101",
+    "001111101",
+    NULL
+};
+
 static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoViewMsgInfo *info) {
 
     if (numbits-6 < 64*2) return false; /* Ask for 64 bit of data (each bit
                                            is two symbols in the bitmap). */
 
-    char *sync[] = {
-        "00111100",
-        "001111100",
-        "00111101",
-        "001111101",
-        NULL
-    };
-
     int j;
     uint32_t off = 0;
-    for (j = 0; sync[j]; j++) {
-        off = bitmap_seek_bits(bits,numbytes,0,numbits,sync[j]);
+    for (j = 0; sync_patterns[j]; j++) {
+        off = info->sync_off[j];
         if (off != BITMAP_SEEK_NOT_FOUND) {
             info->start_off = off;
-            off += strlen(sync[j])-2;
+            off += strlen(sync_patterns[j])-2;
             break;
 	}
     }
     if (off == BITMAP_SEEK_NOT_FOUND) return false;
 
-    FURI_LOG_D(TAG, "Toyota TPMS sync[%s] found", sync[j]);
+    LOG_D("Toyota TPMS sync[%s] found", sync_patterns[j]);
 
     uint8_t raw[9];
     uint32_t decoded =
         convert_from_diff_manchester(raw,sizeof(raw),bits,numbytes,off,true);
-    FURI_LOG_D(TAG, "Toyota TPMS decoded bits: %lu", decoded);
+    LOG_D("Toyota TPMS decoded bits: %lu", decoded);
 
     if (decoded < 8*9) return false; /* Require the full 8 bytes. */
-    if (crc8(raw,8,0x80,7) != raw[8]) return false; /* Require sane CRC. */
+    /* Require sane CRC. */
+    if (crc8(raw,8,0x80,7) != raw[8] && !decoder_fix_crc8(info,raw,8,0x80,7))
+        return false;
 
     /* We detected a valid signal. However now info->start_off is actually
      * pointing to the sync part, not the preamble of alternating 0 and 1.
@@ -75,8 +77,11 @@ static bool decode(uint8_t *bits, uint32_t numbytes, uint32_t numbits, ProtoView
 
     info->pulses_count = (off+8*9*2) - info->start_off;
 
-    float psi = (float)((raw[4]&0x7f)<<1 | raw[5]>>7) * 0.25 - 7;
-    int temp = ((raw[5]&0x7f)<<1 | raw[6]>>7) - 40;
+    /* Pressure and temperature are two bytes starting at bit 33. */
+    BitReader r;
+    bit_reader_init(&r,raw,sizeof(raw),33);
+    float psi = (float)bit_reader_get(&r,8) * 0.25 - 7;
+    int temp = bit_reader_get(&r,8) - 40;
 
     fieldset_add_bytes(info->fieldset,"Tire ID",raw,4*2);
     fieldset_add_float(info->fieldset,"Pressure psi",psi,2);
@@ -88,5 +93,16 @@ ProtoViewDecoder ToyotaTPMSDecoder = {
     .name = "Toyota TPMS",
     .decode = decode,
     .get_fields = NULL,
-    .build_message = NULL
+    .build_message = NULL,
+    .sync = sync_patterns,
+    .allow_inverted = true,
+    .mod_class = MOD_CLASS_FSK,
+    .line_code = LineCodeDiffManchester,
+    .symbol_us = 52,
+    .symbol_min_us = 35,
+    .symbol_max_us = 75,
+    .min_bits = 134,
+    .max_bits = 150,
+    .check_bits = 8,
+    .crc_fix = true
 };
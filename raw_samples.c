@@ -11,6 +11,7 @@
 RawSamplesBuffer *raw_samples_alloc(void) {
     RawSamplesBuffer *buf = malloc(sizeof(*buf));
     buf->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    buf->seq = 0;
     raw_samples_reset(buf);
     return buf;
 }
@@ -29,6 +30,8 @@ void raw_samples_reset(RawSamplesBuffer *s) {
     s->total = RAW_SAMPLES_NUM;
     s->idx = 0;
     s->short_pulse_dur = 0;
+    s->regularity = 0;
+    s->level_bias = 0;
     memset(s->samples,0,sizeof(s->samples));
     furi_mutex_release(s->mutex);
 }
@@ -45,6 +48,7 @@ void raw_samples_add(RawSamplesBuffer *s, bool level, uint32_t dur) {
     s->samples[s->idx].level = level;
     s->samples[s->idx].dur = dur;
     s->idx = (s->idx+1) % RAW_SAMPLES_NUM;
+    s->seq++;
     furi_mutex_release(s->mutex);
 }
 
@@ -69,6 +73,7 @@ void raw_samples_add_or_update(RawSamplesBuffer *s, bool level, uint32_t dur) {
         s->samples[s->idx].level = level;
         s->samples[s->idx].dur = dur;
         s->idx = (s->idx+1) % RAW_SAMPLES_NUM;
+        s->seq++;
     }
     furi_mutex_release(s->mutex);
 }
@@ -89,7 +94,10 @@ void raw_samples_copy(RawSamplesBuffer *dst, RawSamplesBuffer *src) {
     furi_mutex_acquire(src->mutex,FuriWaitForever);
     furi_mutex_acquire(dst->mutex,FuriWaitForever);
     dst->idx = src->idx;
+    dst->seq = src->seq;
     dst->short_pulse_dur = src->short_pulse_dur;
+    dst->regularity = src->regularity;
+    dst->level_bias = src->level_bias;
     memcpy(dst->samples,src->samples,sizeof(dst->samples));
     furi_mutex_release(src->mutex);
     furi_mutex_release(dst->mutex);
@@ -18,8 +18,15 @@ typedef struct RawSamplesBuffer {
                        this field for a cleaner interface with the user, but
                        we always use RAW_SAMPLES_NUM when taking the modulo so
                        the compiler can optimize % as bit masking. */
+    uint32_t seq;   /* Number of samples ever added. Not cleared by
+                       raw_samples_reset(), so that 'seq' identifies a sample
+                       position in the stream across resets. */
     /* Signal features. */
     uint32_t short_pulse_dur; /* Duration of the shortest pulse. */
+    uint32_t regularity;      /* Percentage of pulses that are close to an
+                                 integer multiple of the short pulse. */
+    int32_t level_bias;       /* How much high pulses are stretched, and low
+                                 pulses shrunk, by the receiver (us). */
 } RawSamplesBuffer;
 
 RawSamplesBuffer *raw_samples_alloc(void);
@@ -4,8 +4,10 @@
  * Modified: TPMS Reader - Only TPMS protocol decoders are registered. */
 
 #include "app.h"
+#include "protocols/generated/decoders.h"
 
-bool decode_signal(RawSamplesBuffer *s, uint64_t len, ProtoViewMsgInfo *info);
+bool decode_signal(ProtoViewApp *app, RawSamplesBuffer *s, uint64_t len, const ProtoViewDetectProfile *profile, uint32_t mod_class, const uint8_t *order, ProtoViewMsgInfo *info);
+bool decode_combined(ProtoViewApp *app, RawSamplesBuffer *s, ProtoViewScanCandidate **copies, uint32_t numcopies, uint32_t j, bool inverted, ProtoViewMsgInfo *info);
 
 /* =============================================================================
  * TPMS Protocols table.
@@ -14,34 +16,40 @@ bool decode_signal(RawSamplesBuffer *s, uint64_t len, ProtoViewMsgInfo *info);
 
 extern ProtoViewDecoder RenaultTPMSDecoder;
 extern ProtoViewDecoder ToyotaTPMSDecoder;
-extern ProtoViewDecoder SchraderTPMSDecoder;
 extern ProtoViewDecoder SchraderEG53MA4TPMSDecoder;
-extern ProtoViewDecoder CitroenTPMSDecoder;
 extern ProtoViewDecoder FordTPMSDecoder;
-extern ProtoViewDecoder HyundaiKiaTPMSDecoder;
 extern ProtoViewDecoder GMTPMSDecoder;
 extern ProtoViewDecoder PMV107JTPMSDecoder;
-extern ProtoViewDecoder Elantra2012TPMSDecoder;
 extern ProtoViewDecoder BMWTPMSDecoder;
 extern ProtoViewDecoder BMWGen3TPMSDecoder;
-extern ProtoViewDecoder PorscheTPMSDecoder;
 extern ProtoViewDecoder SchraderSMD3MA4TPMSDecoder;
 
+/* The order is the priority of the decoders when more than one can
+ * accept a signal. Decoders generated from protocols/specs are placed by
+ * the "slot" of their spec: GENERATED_DECODERS_AT_<n> (see
+ * tools/protogen.py and protocols/generated/decoders.h) lists the ones
+ * that go after the first n hand-written decoders. Adding a hand-written
+ * decoder means adding a slot here and in SLOTS of protogen.py. */
 ProtoViewDecoder *Decoders[] = {
+    GENERATED_DECODERS_AT_0
     &PMV107JTPMSDecoder,        /* Toyota Highlander, Camry, Lexus (US). */
-    &Elantra2012TPMSDecoder,    /* Hyundai Elantra 2012 / Honda Civic. */
+    GENERATED_DECODERS_AT_1     /* Elantra 2012 / Honda Civic. */
     &BMWTPMSDecoder,            /* BMW Gen4/5 and Audi. */
+    GENERATED_DECODERS_AT_2
     &BMWGen3TPMSDecoder,        /* BMW Gen2/Gen3. */
-    &PorscheTPMSDecoder,        /* Porsche Boxster/Cayman. */
+    GENERATED_DECODERS_AT_3     /* Porsche Boxster/Cayman. */
     &SchraderSMD3MA4TPMSDecoder,/* Schrader SMD3MA4 (Subaru, Nissan, etc). */
+    GENERATED_DECODERS_AT_4
     &RenaultTPMSDecoder,
+    GENERATED_DECODERS_AT_5
     &ToyotaTPMSDecoder,
-    &SchraderTPMSDecoder,
+    GENERATED_DECODERS_AT_6     /* Schrader. */
     &SchraderEG53MA4TPMSDecoder,
-    &CitroenTPMSDecoder,
+    GENERATED_DECODERS_AT_7     /* Citroen. */
     &FordTPMSDecoder,
-    &HyundaiKiaTPMSDecoder,
+    GENERATED_DECODERS_AT_8     /* Hyundai/Kia. */
     &GMTPMSDecoder,
+    GENERATED_DECODERS_AT_9
     NULL
 };
 
@@ -59,19 +67,19 @@ void reset_current_signal(ProtoViewApp *app) {
     app->signal_decoded = false;
     raw_samples_reset(DetectedSamples);
     raw_samples_reset(RawSamples);
-    free_msg_info(app->msg_info);
-    app->msg_info = NULL;
+    scan_free_msgs(app);
 }
 
-#define SEARCH_CLASSES 3
-uint32_t search_coherent_signal(RawSamplesBuffer *s, uint32_t idx, uint32_t min_duration) {
+uint32_t search_coherent_signal(RawSamplesBuffer *s, uint32_t idx, uint32_t min_duration, const ProtoViewDetectProfile *profile) {
     struct {
         uint32_t dur[2];
         uint32_t count[2];
-    } classes[SEARCH_CLASSES];
+    } classes[DETECT_MAX_CLASSES];
 
     memset(classes, 0, sizeof(classes));
-    uint32_t max_duration = 6000;
+    uint32_t max_duration = profile->max_duration;
+    uint32_t numclasses = profile->search_classes;
+    if (numclasses > DETECT_MAX_CLASSES) numclasses = DETECT_MAX_CLASSES;
     uint32_t len = 0;
     s->short_pulse_dur = 0;
 
@@ -83,7 +91,7 @@ uint32_t search_coherent_signal(RawSamplesBuffer *s, uint32_t idx, uint32_t min_
         if (dur < min_duration || dur > max_duration) break;
 
         uint32_t k;
-        for (k = 0; k < SEARCH_CLASSES; k++) {
+        for (k = 0; k < numclasses; k++) {
             if (classes[k].count[level] == 0) {
                 classes[k].dur[level] = dur;
                 classes[k].count[level] = 1;
@@ -92,7 +100,7 @@ uint32_t search_coherent_signal(RawSamplesBuffer *s, uint32_t idx, uint32_t min_
                 uint32_t classavg = classes[k].dur[level];
                 uint32_t count = classes[k].count[level];
                 uint32_t delta = duration_delta(dur, classavg);
-                if (delta < classavg / 3) {
+                if (delta < classavg / profile->class_tolerance_div) {
                     classavg = ((classavg * count) + dur) / (count + 1);
                     classes[k].dur[level] = classavg;
                     classes[k].count[level]++;
@@ -101,12 +109,12 @@ uint32_t search_coherent_signal(RawSamplesBuffer *s, uint32_t idx, uint32_t min_
             }
         }
 
-        if (k == SEARCH_CLASSES) break;
+        if (k == numclasses) break;
         len++;
     }
 
     uint32_t short_dur[2] = {0, 0};
-    for (int j = 0; j < SEARCH_CLASSES; j++) {
+    for (uint32_t j = 0; j < numclasses; j++) {
         for (int level = 0; level < 2; level++) {
             if (classes[j].dur[level] == 0) continue;
             if (classes[j].count[level] < 3) continue;
@@ -122,74 +130,553 @@ uint32_t search_coherent_signal(RawSamplesBuffer *s, uint32_t idx, uint32_t min_
     if (short_dur[1] == 0) short_dur[1] = short_dur[0];
     s->short_pulse_dur = (short_dur[0] + short_dur[1]) / 2;
 
+    /* OOK receivers tend to stretch high pulses and shrink low pulses by
+     * a fixed amount: if the short pulses of the two levels differ, half
+     * the difference is that bias. Tiny differences are just jitter in
+     * the class averages, while a difference larger than a third of the
+     * short pulse is more likely a property of the line code itself:
+     * both are ignored. */
+    int32_t bias = ((int32_t)short_dur[1] - (int32_t)short_dur[0]) / 2;
+    uint32_t absbias = abs(bias);
+    if (absbias * 8 < s->short_pulse_dur ||
+        absbias * 3 >= s->short_pulse_dur) bias = 0;
+    s->level_bias = bias;
+
+    /* Regularity: how many pulses fall into classes that are (close to)
+     * an integer multiple of the short pulse of the same level. Real
+     * line codes score near 100%, noise that happened to fit into
+     * three classes scores much lower. */
+    uint32_t regular = 0;
+    for (uint32_t j = 0; j < numclasses; j++) {
+        for (int level = 0; level < 2; level++) {
+            uint32_t unit = short_dur[level];
+            if (classes[j].count[level] == 0 || unit == 0) continue;
+            uint32_t mult = (classes[j].dur[level] + unit / 2) / unit;
+            if (mult == 0) mult = 1;
+            if (duration_delta(classes[j].dur[level], mult * unit) < unit / 4)
+                regular += classes[j].count[level];
+        }
+    }
+    s->regularity = len ? regular * 100 / len : 0;
+
     return len;
 }
 
-void scan_for_signal(ProtoViewApp *app, RawSamplesBuffer *source, uint32_t min_duration) {
-    RawSamplesBuffer *copy = raw_samples_alloc();
-    raw_samples_copy(copy, source);
+/* Return true if decoder 'd' can receive signals demodulated as
+ * 'mod_class' and sampled at 'rate' us per symbol. */
+static bool decoder_accepts(const ProtoViewDecoder *d, uint32_t mod_class,
+                            uint32_t rate)
+{
+    if (d->mod_class && mod_class && !(d->mod_class & mod_class))
+        return false;
+    if (d->symbol_max_us &&
+        (rate < d->symbol_min_us || rate > d->symbol_max_us))
+        return false;
+    return true;
+}
+
+/* Store in 'rates' the nominal symbol times of the decoders that can
+ * receive 'mod_class' signals, ascending and without duplicates, and
+ * return how many they are. 'rates' must hold COUNT_OF(Decoders). */
+static uint32_t nominal_rates(uint32_t mod_class, uint32_t *rates) {
+    uint32_t count = 0;
+    for (uint32_t j = 0; Decoders[j]; j++) {
+        const ProtoViewDecoder *d = Decoders[j];
+        uint32_t rate = d->symbol_us;
+        if (rate == 0 || !decoder_accepts(d, mod_class, rate)) continue;
+
+        uint32_t i = count;
+        while (i > 0 && rates[i - 1] > rate) i--;
+        if (i > 0 && rates[i - 1] == rate) continue;
+        memmove(rates + i + 1, rates + i, (count - i) * sizeof(*rates));
+        rates[i] = rate;
+        count++;
+    }
+    return count;
+}
+
+/* Score a coherent run: 0..300, the sum of three 0..100 components for
+ * length, regularity of the pulse classes and closeness of the symbol
+ * time to the nominal rate of one of the decoders for 'mod_class'. */
+static uint32_t score_candidate(uint32_t len, uint32_t regularity, uint32_t dur,
+                                uint32_t mod_class)
+{
+    uint32_t len_score = len >= 300 ? 100 : len / 3;
+
+    uint32_t rates[COUNT_OF(Decoders)];
+    uint32_t numrates = nominal_rates(mod_class, rates);
+    uint32_t best = UINT32_MAX;
+    uint32_t nearest = 1;
+    for (uint32_t j = 0; j < numrates; j++) {
+        uint32_t delta = duration_delta(dur, rates[j]);
+        if (delta < best) {
+            best = delta;
+            nearest = rates[j];
+        }
+    }
+    uint32_t rate_err = best * 100 / nearest;
+    uint32_t rate_score = rate_err >= 100 ? 0 : 100 - rate_err;
+
+    return len_score + regularity + rate_score;
+}
+
+/* Add a candidate to the list, keeping only the SCAN_MAX_CANDIDATES
+ * best ones if the list is full. Returns the new number of candidates. */
+static uint32_t add_candidate(ProtoViewScanCandidate *cand, uint32_t count,
+                              ProtoViewScanCandidate *c)
+{
+    if (count < SCAN_MAX_CANDIDATES) {
+        cand[count] = *c;
+        return count + 1;
+    }
+    uint32_t worst = 0;
+    for (uint32_t j = 1; j < count; j++)
+        if (cand[j].score < cand[worst].score) worst = j;
+    if (c->score > cand[worst].score) cand[worst] = *c;
+    return count;
+}
 
+/* Sort candidates by descending score, the ones that already failed in an
+ * earlier scan last. Insertion sort: the list is tiny, and being stable,
+ * runs with the same score keep the buffer order. */
+static void sort_candidates(ProtoViewScanCandidate *cand, uint32_t count) {
+    for (uint32_t j = 1; j < count; j++) {
+        ProtoViewScanCandidate c = cand[j];
+        uint32_t k = j;
+        while (k > 0 && (cand[k - 1].failed > c.failed ||
+                         (cand[k - 1].failed == c.failed &&
+                          cand[k - 1].score < c.score)))
+        {
+            cand[k] = cand[k - 1];
+            k--;
+        }
+        cand[k] = c;
+    }
+}
+
+/* Negative cache key of the run of 'len' samples at 'off' in the buffer:
+ * FNV-1a hash of the stream position of the run and of its samples. The
+ * position changes only when new samples arrive, so the same run seen by
+ * two scans of the ring has the same key, while a new transmission that
+ * looks exactly the same gets a different one. Never returns zero, that
+ * marks empty cache slots. */
+static uint32_t run_cache_key(RawSamplesBuffer *s, uint32_t off, uint32_t len) {
+    uint32_t h = 2166136261u;
+    uint32_t pos = s->seq - RAW_SAMPLES_NUM + off;
+    for (int j = 0; j < 4; j++) {
+        h ^= (pos >> (j * 8)) & 0xff;
+        h *= 16777619u;
+    }
+    for (uint32_t j = off; j < off + len; j++) {
+        bool level;
+        uint32_t dur;
+        raw_samples_get(s, j, &level, &dur);
+        uint32_t v = (dur << 1) | level;
+        h ^= v & 0xff;
+        h *= 16777619u;
+        h ^= (v >> 8) & 0xff;
+        h *= 16777619u;
+    }
+    return h ? h : 1;
+}
+
+/* Return the slot of 'key' in the cache, or -1 if it is not there. */
+static int negcache_lookup(ProtoViewNegCache *nc, uint32_t key) {
+    for (uint32_t j = 0; j < NEGCACHE_SIZE; j++)
+        if (nc->keys[j] == key) return j;
+    return -1;
+}
+
+/* Remember a run that failed all the decoders, with the decoders whose
+ * sync was found in it, evicting the oldest one. A run already in the
+ * cache is updated in place. */
+static void negcache_add(ProtoViewNegCache *nc, uint32_t key,
+                         const uint32_t *synced)
+{
+    int slot = negcache_lookup(nc, key);
+    if (slot < 0) {
+        slot = nc->next;
+        nc->next = (nc->next + 1) % NEGCACHE_SIZE;
+    }
+    nc->keys[slot] = key;
+    nc->synced[slot][0] = synced[0];
+    nc->synced[slot][1] = synced[1];
+}
+
+/* Return true if the cycles elapsed since 'start' exceed 'budget_us'. */
+static bool budget_exceeded(uint32_t start, uint32_t budget_us) {
+    uint32_t elapsed = DWT->CYCCNT - start;
+    return elapsed > budget_us * furi_hal_cortex_instructions_per_microsecond();
+}
+
+/* Start scanning a snapshot of 'source' for coherent signals, using the
+ * duration filter and detection profile of the modulation 'mod'. The actual
+ * work is performed by scan_step(), so that it can be split across
+ * multiple main loop iterations. A scan already in progress is dropped. */
+void scan_start(ProtoViewApp *app, RawSamplesBuffer *source, const ProtoViewModulation *mod) {
+    ProtoViewScanState *scan = &app->scan;
+    raw_samples_copy(scan->copy, source);
+    scan->phase = ScanPhaseCollect;
+    scan->min_duration = mod->duration_filter;
+    scan->profile = mod->profile;
+    scan->mod_class = mod->mod_class;
+    scan->preset = mod - ProtoViewModulations;
+    if (scan->preset >= RANK_MAX_PRESETS) scan->preset = RANK_MAX_PRESETS - 1;
+    scan->cursor = 0;
+    scan->decode_cycles = 0;
+    scan->numcand = 0;
+    scan_free_msgs(app);
     app->dbg_scan_count++;
+    TRACE(TraceScanStart, source->seq, app->modulation);
+}
 
-    uint32_t minlen = 30; /* Lowered to catch shorter/noisier TPMS fragments. */
-    uint32_t i = 0;
-    uint32_t coherent_log_count = 0; /* Rate-limit COHERENT debug logs. */
+bool scan_in_progress(ProtoViewApp *app) {
+    return app->scan.phase != ScanPhaseIdle;
+}
 
-    while (i < copy->total - 1) {
-        uint32_t thislen = search_coherent_signal(copy, i, min_duration);
+/* Free the messages decoded by the last scan, once they were stored. */
+void scan_free_msgs(ProtoViewApp *app) {
+    ProtoViewScanState *scan = &app->scan;
+    for (uint32_t j = 0; j < scan->nummsgs; j++) free_msg_info(scan->msgs[j]);
+    scan->nummsgs = 0;
+}
+
+/* Collect phase: every coherent run longer than the profile minlen
+ * becomes a candidate, scored by score_candidate(), unless it is in the
+ * negative cache. Returns false if the step budget was exhausted before reaching
+ * the end of the buffer. */
+static bool scan_collect(ProtoViewApp *app, uint32_t step_start) {
+    ProtoViewScanState *scan = &app->scan;
+    RawSamplesBuffer *copy = scan->copy;
+    uint32_t minlen = scan->profile.minlen;
+
+    while (scan->cursor < copy->total - 1) {
+        if (budget_exceeded(step_start, app->scan_step_budget_us))
+            return false;
+
+        uint32_t i = scan->cursor;
+        uint32_t thislen = search_coherent_signal(copy, i, scan->min_duration,
+                                                  &scan->profile);
 
         if (thislen > minlen) {
             app->dbg_coherent_count++;
             app->dbg_last_signal_len = thislen;
             app->dbg_last_signal_dur = copy->short_pulse_dur;
 
-            /* Log COHERENT event (rate-limited to 3 per scan call). */
-            if (coherent_log_count < 3) {
-                coherent_log_count++;
-                char detail[48];
-                snprintf(detail, sizeof(detail), "len=%lu dur=%lu",
-                         (unsigned long)thislen,
-                         (unsigned long)copy->short_pulse_dur);
-                tpms_debug_log(app, "COHERENT", detail);
+            TRACE(TraceCoherent, thislen, copy->short_pulse_dur);
+
+            uint32_t key = run_cache_key(copy, i, thislen);
+            ProtoViewScanCandidate c = {
+                .off = i,
+                .len = thislen,
+                .short_pulse_dur = copy->short_pulse_dur,
+                .level_bias = copy->level_bias,
+                .score = score_candidate(thislen, copy->regularity,
+                                         copy->short_pulse_dur,
+                                         scan->mod_class),
+                .key = key,
+            };
+            int slot = negcache_lookup(&app->negcache, key);
+            if (slot >= 0) {
+                /* Not decoded again, but still a copy to combine. */
+                app->dbg_negcache_hit++;
+                c.failed = true;
+                c.score = 0;
+                c.synced[0] = app->negcache.synced[slot][0];
+                c.synced[1] = app->negcache.synced[slot][1];
+                if (c.synced[0] | c.synced[1])
+                    scan->numcand = add_candidate(scan->cand, scan->numcand,
+                                                  &c);
+            } else {
+                app->dbg_negcache_miss++;
+                scan->numcand = add_candidate(scan->cand, scan->numcand, &c);
             }
+        }
+        scan->cursor += thislen ? thislen : 1;
+    }
+    return true;
+}
 
-            ProtoViewMsgInfo *info = malloc(sizeof(ProtoViewMsgInfo));
-            init_msg_info(info, app);
-            info->short_pulse_dur = copy->short_pulse_dur;
+/* Log the decoders that accepted the last run in evaluate-all mode, and
+ * count the runs more than one protocol accepted. */
+static void scan_log_matches(ProtoViewApp *app) {
+    ProtoViewDecodeCtx *ctx = &app->decode;
+    if (ctx->nummatches == 0) return;
+
+    bool conflict = false;
+    for (uint32_t k = 1; k < ctx->nummatches; k++)
+        if (ctx->matches[k].decoder != ctx->matches[0].decoder)
+            conflict = true;
+    if (conflict) app->dbg_decode_conflict_count++;
+
+    for (uint32_t k = 0; k < ctx->nummatches; k++) {
+        ProtoViewDecodeMatch *dm = &ctx->matches[k];
+        char detail[64];
+        snprintf(detail, sizeof(detail), "%s score=%d rate=%u%s%s",
+                 Decoders[dm->decoder]->name, dm->score, dm->rate,
+                 dm->inverted ? " (inverted)" : "",
+                 dm->kept ? " kept" : "");
+        tpms_debug_log(app, "MATCH", detail);
+    }
+}
+
+/* Add the decoded message 'info' to the ones of this scan, or free it if
+ * it is a repeat of one of them (same decoder and frame bits), or if there
+ * is no room left. */
+static void scan_add_msg(ProtoViewScanState *scan, ProtoViewMsgInfo *info) {
+    for (uint32_t j = 0; j < scan->nummsgs; j++) {
+        ProtoViewMsgInfo *m = scan->msgs[j];
+        if (m->decoder == info->decoder && m->bits_bytes == info->bits_bytes &&
+            (m->bits_bytes == 0 ||
+             memcmp(m->bits, info->bits, m->bits_bytes) == 0))
+        {
+            free_msg_info(info);
+            return;
+        }
+    }
+    if (scan->nummsgs == SCAN_MAX_MSGS) {
+        free_msg_info(info);
+        return;
+    }
+    scan->msgs[scan->nummsgs++] = info;
+}
+
+/* Keep 'info' if it was decoded from the candidate 'c', and show 'c' in
+ * DetectedSamples if it is better than the signal shown: the first
+ * decoded one, or else the longest. */
+static void scan_keep_signal(ProtoViewApp *app, ProtoViewScanCandidate *c,
+                             ProtoViewMsgInfo *info, bool decoded)
+{
+    RawSamplesBuffer *copy = app->scan.copy;
+    bool oldsignal_not_decoded = app->signal_decoded == false;
+
+    if (decoded)
+        scan_add_msg(&app->scan, info);
+    else
+        free_msg_info(info);
+
+    if (oldsignal_not_decoded &&
+        (c->len > app->signal_bestlen || decoded))
+    {
+        app->signal_bestlen = c->len;
+        app->signal_decoded = decoded;
+        raw_samples_copy(DetectedSamples, copy);
+        raw_samples_center(DetectedSamples, c->off);
+        LOG_D("===> Signal updated (%d samples %lu us)",
+            (int)c->len, DetectedSamples->short_pulse_dur);
+    }
+}
 
-            uint32_t saved_idx = copy->idx;
-            raw_samples_center(copy, i);
+/* Decode a single candidate, updating the current best signal. */
+static void scan_decode_candidate(ProtoViewApp *app, ProtoViewScanCandidate *c) {
+    RawSamplesBuffer *copy = app->scan.copy;
+    uint32_t thislen = c->len;
+    uint32_t i = c->off;
+    copy->short_pulse_dur = c->short_pulse_dur;
+    copy->level_bias = c->level_bias;
 
-            app->dbg_decode_try_count++;
-            bool decoded = decode_signal(copy, thislen, info);
-            if (decoded) {
-                app->dbg_decode_ok_count++;
-                tpms_debug_log(app, "DECODE_OK",
-                               info->decoder ? info->decoder->name : "");
+    ProtoViewMsgInfo *info = malloc(sizeof(ProtoViewMsgInfo));
+    init_msg_info(info, app);
+    info->short_pulse_dur = copy->short_pulse_dur;
+
+    uint32_t saved_idx = copy->idx;
+    raw_samples_center(copy, i);
+
+    app->dbg_decode_try_count++;
+    uint32_t preset = app->scan.preset;
+    bool decoded = decode_signal(app, copy, thislen, &app->scan.profile,
+                                 app->scan.mod_class, app->rank.order[preset],
+                                 info);
+    if (decoded) {
+        app->dbg_decode_ok_count++;
+        decoder_rank_hit(&app->rank, preset, info->decoder);
+        if (info->inverted) app->dbg_inverted_ok_count++;
+        for (uint32_t k = 0; k < DECODER_MAX_SYNC; k++) {
+            if (info->sync_errors[k]) {
+                app->dbg_sync_errors_ok_count++;
+                break;
             }
+        }
+        if (info->fixed_bits) app->dbg_crc_fixed_ok_count++;
+        char detail[64];
+        snprintf(detail, sizeof(detail), "%s%s%s",
+                 info->decoder ? info->decoder->name : "",
+                 info->inverted ? " (inverted)" : "",
+                 info->fixed_bits ? " (corrected)" : "");
+        tpms_debug_log(app, "DECODE_OK", detail);
+        for (uint32_t j = 0; Decoders[j]; j++)
+            if (Decoders[j] == info->decoder) c->decoded = 1UL << j;
+    } else {
+        c->synced[0] = app->decode.synced[0];
+        c->synced[1] = app->decode.synced[1];
+        negcache_add(&app->negcache, c->key, c->synced);
+    }
+    scan_log_matches(app);
 
-            copy->idx = saved_idx;
+    copy->idx = saved_idx;
+    scan_keep_signal(app, c, info, decoded);
+}
 
-            bool oldsignal_not_decoded = app->signal_decoded == false;
+/* Decode phase: candidates are decoded best first, at most
+ * app->scan_top_k of them, and only as long as the total decoding time
+ * of this scan stays within app->scan_budget_us. The others are deferred:
+ * if they are still in the buffer, the next scan will consider them again.
+ * Returns false if the step budget was exhausted first. */
+static bool scan_decode(ProtoViewApp *app, uint32_t step_start) {
+    ProtoViewScanState *scan = &app->scan;
+    uint32_t budget_cycles =
+        app->scan_budget_us * furi_hal_cortex_instructions_per_microsecond();
 
-            if (oldsignal_not_decoded &&
-                (thislen > app->signal_bestlen || decoded))
-            {
-                free_msg_info(app->msg_info);
-                app->msg_info = info;
-                app->signal_bestlen = thislen;
-                app->signal_decoded = decoded;
-                raw_samples_copy(DetectedSamples, copy);
-                raw_samples_center(DetectedSamples, i);
-                FURI_LOG_D(TAG, "===> Signal updated (%d samples %lu us)",
-                    (int)thislen, DetectedSamples->short_pulse_dur);
-            } else {
+    while (scan->cursor < scan->numcand) {
+        /* The runs that already failed are sorted last. */
+        if (scan->cand[scan->cursor].failed) break;
+
+        /* Always decode at least one candidate, so that a too small
+         * budget can't stop the scanner from making progress. */
+        if (scan->cursor > 0 && (scan->cursor >= app->scan_top_k ||
+                                 scan->decode_cycles > budget_cycles))
+        {
+            app->dbg_deferred_count += scan->numcand - scan->cursor;
+            break;
+        }
+        if (budget_exceeded(step_start, app->scan_step_budget_us))
+            return false;
+
+        uint32_t decode_start = DWT->CYCCNT;
+        scan_decode_candidate(app, &scan->cand[scan->cursor]);
+        scan->decode_cycles += DWT->CYCCNT - decode_start;
+        scan->cursor++;
+    }
+    return true;
+}
+
+/* Combine phase: the candidates no decoder accepted are grouped by the
+ * decoders whose sync was found in them, and each group of at least
+ * COMBINE_MIN_COPIES is decoded once by that decoder, see
+ * decode_combined(). The scanned buffer is the time window: it holds a
+ * burst of repeats, including runs that failed in the earlier scans of a
+ * burst still being received, kept by the negative cache. Decoders are
+ * tried in rank order, and not at all if they accepted one of the
+ * candidates, since then a single copy already passed the check.
+ * Combining shares the scan budget with decoding: both budgets are
+ * checked before every combined decode, and scan->group records the next
+ * group to try. Returns false if the step budget was exhausted first. */
+static bool scan_combine(ProtoViewApp *app, uint32_t step_start) {
+    ProtoViewScanState *scan = &app->scan;
+    uint32_t budget_cycles =
+        app->scan_budget_us * furi_hal_cortex_instructions_per_microsecond();
+    const uint8_t *order = app->rank.order[scan->preset];
+    uint32_t numgroups = (COUNT_OF(Decoders) - 1) * 2;
+
+    uint32_t decoded = 0;
+    for (uint32_t j = 0; j < scan->numcand; j++)
+        decoded |= scan->cand[j].decoded;
+
+    for (; scan->cursor < scan->numcand; scan->cursor++, scan->group = 0) {
+        ProtoViewScanCandidate *c = &scan->cand[scan->cursor];
+        for (; scan->group < numgroups; scan->group++) {
+            uint32_t n = scan->group / 2, inv = scan->group % 2;
+            uint32_t bit = 1UL << order[n];
+            if (!(c->synced[inv] & bit) || (decoded & bit)) continue;
+            if (Decoders[order[n]]->max_bits + COMBINE_TAIL_BITS >
+                COMBINE_MAX_BITS) continue;
+
+            /* A group is tried once, from its first candidate. */
+            bool tried = false;
+            for (uint32_t j = 0; j < scan->cursor; j++)
+                if (scan->cand[j].synced[inv] & bit) tried = true;
+            if (tried) continue;
+
+            ProtoViewScanCandidate *copies[COMBINE_MAX_COPIES];
+            uint32_t numcopies = 0;
+            for (uint32_t j = scan->cursor; j < scan->numcand; j++) {
+                if ((scan->cand[j].synced[inv] & bit) &&
+                    numcopies < COMBINE_MAX_COPIES)
+                    copies[numcopies++] = &scan->cand[j];
+            }
+            if (numcopies < COMBINE_MIN_COPIES) continue;
+
+            if (scan->decode_cycles > budget_cycles) return true;
+            if (budget_exceeded(step_start, app->scan_step_budget_us))
+                return false;
+
+            uint32_t decode_start = DWT->CYCCNT;
+            ProtoViewMsgInfo *info = malloc(sizeof(ProtoViewMsgInfo));
+            init_msg_info(info, app);
+            bool ok = decode_combined(app, scan->copy, copies, numcopies,
+                                      order[n], inv, info);
+            scan->decode_cycles += DWT->CYCCNT - decode_start;
+            if (!ok) {
                 free_msg_info(info);
+                continue;
             }
+
+            app->dbg_decode_ok_count++;
+            app->dbg_combined_ok_count++;
+            decoder_rank_hit(&app->rank, scan->preset, info->decoder);
+            char detail[64];
+            snprintf(detail, sizeof(detail), "%s%s (combined %lu)",
+                     info->decoder->name,
+                     info->inverted ? " (inverted)" : "",
+                     (unsigned long)numcopies);
+            tpms_debug_log(app, "DECODE_OK", detail);
+            scan_keep_signal(app, c, info, true);
+
+            /* The copies are used up, in later scans as well. */
+            for (uint32_t k = 0; k < numcopies; k++) {
+                copies[k]->synced[0] = copies[k]->synced[1] = 0;
+                negcache_add(&app->negcache, copies[k]->key,
+                             copies[k]->synced);
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+/* Run the scan started with scan_start() for at most
+ * app->scan_step_budget_us. Returns true when the scan is complete (or
+ * there is no scan in progress), false if it was paused and scan_step()
+ * should be called again. The budget is checked between coherent runs
+ * and between candidates, so a step can overrun it by one of them. */
+bool scan_step(ProtoViewApp *app) {
+    ProtoViewScanState *scan = &app->scan;
+    uint32_t step_start = DWT->CYCCNT;
+    bool done = false;
+
+    if (scan->phase == ScanPhaseIdle) return true;
+    app->dbg_scan_step_count++;
+
+    if (scan->phase == ScanPhaseCollect) {
+        if (scan_collect(app, step_start)) {
+            sort_candidates(scan->cand, scan->numcand);
+            scan->phase = ScanPhaseDecode;
+            scan->cursor = 0;
         }
-        i += thislen ? thislen : 1;
     }
-    raw_samples_free(copy);
+    if (scan->phase == ScanPhaseDecode) {
+        if (scan_decode(app, step_start)) {
+            scan->phase = ScanPhaseCombine;
+            scan->cursor = 0;
+            scan->group = 0;
+        }
+    }
+    if (scan->phase == ScanPhaseCombine) {
+        if (scan_combine(app, step_start)) {
+            scan->phase = ScanPhaseIdle;
+            done = true;
+        }
+    }
+    if (!done) app->dbg_budget_hit_count++;
+    return done;
+}
+
+/* Scan the buffer for coherent signals, running the whole scan at once.
+ * The main loop uses scan_start() / scan_step() instead, to avoid blocking
+ * the GUI on a busy band. */
+void scan_for_signal(ProtoViewApp *app, RawSamplesBuffer *source, const ProtoViewModulation *mod) {
+    scan_start(app, source, mod);
+    while (!scan_step(app));
 }
 
 /* =============================================================================
@@ -206,6 +693,49 @@ void bitmap_set(uint8_t *b, uint32_t blen, uint32_t bitpos, bool val) {
         b[byte] &= ~(1 << bit);
 }
 
+/* Set 'count' bits starting at 'bitpos' to 'val'. The partial bytes at
+ * the two ends of the run are written with a mask, the whole bytes in the
+ * middle with memset(). Bits past the end of the bitmap are discarded,
+ * like bitmap_set() does. */
+void bitmap_set_run(uint8_t *b, uint32_t blen, uint32_t bitpos, uint32_t count, bool val) {
+    if (count == 0) return;
+    uint32_t byte = bitpos / 8;
+    uint32_t last = (bitpos + count - 1) / 8;
+    if (byte >= blen) return;
+    uint8_t fill = val ? 0xff : 0x00;
+
+    uint8_t head = 0xff >> (bitpos & 7);
+    if (byte == last) {
+        /* Run inside a single byte. */
+        uint8_t mask = head & (0xff << (7 - ((bitpos + count - 1) & 7)));
+        b[byte] = (b[byte] & ~mask) | (fill & mask);
+        return;
+    }
+    b[byte] = (b[byte] & ~head) | (fill & head);
+    byte++;
+
+    uint32_t end = last < blen ? last : blen;
+    if (end > byte) memset(b + byte, fill, end - byte);
+    if (last >= blen) return;
+
+    uint8_t tail = 0xff << (7 - ((bitpos + count - 1) & 7));
+    b[last] = (b[last] & ~tail) | (fill & tail);
+}
+
+/* Invert the first 'numbits' bits of the bitmap in place, a word at a
+ * time, see bitops_load_be32(). The bits after 'numbits' are left
+ * untouched. */
+void bitmap_invert(uint8_t *b, uint32_t blen, uint32_t numbits) {
+    uint32_t bytes = numbits / 8;
+    if (bytes > blen) bytes = blen;
+    uint32_t j = 0;
+    for (; j + 4 <= bytes; j += 4)
+        bitops_store_be32(b + j, ~bitops_load_be32(b + j));
+    while (j < bytes) b[j++] ^= 0xff;
+    if ((numbits & 7) && bytes < blen)
+        b[bytes] ^= 0xff << (8 - (numbits & 7));
+}
+
 bool bitmap_get(uint8_t *b, uint32_t blen, uint32_t bitpos) {
     uint32_t byte = bitpos / 8;
     uint32_t bit = 7 - (bitpos & 7);
@@ -213,56 +743,22 @@ bool bitmap_get(uint8_t *b, uint32_t blen, uint32_t bitpos) {
     return (b[byte] & (1 << bit)) != 0;
 }
 
+/* Copy 'count' bits from the bitmap 's' at offset 'soff' to the bitmap
+ * 'd' at offset 'doff'. Source bits past the end of 's' read as zero, and
+ * bits past the end of 'd' are discarded. */
 void bitmap_copy(uint8_t *d, uint32_t dlen, uint32_t doff,
                  uint8_t *s, uint32_t slen, uint32_t soff,
                  uint32_t count)
 {
-    if ((doff & 7) == 0 && (soff & 7) == 0) {
-        uint32_t didx = doff / 8;
-        uint32_t sidx = soff / 8;
-        while (count > 8 && didx < dlen && sidx < slen) {
-            d[didx++] = s[sidx++];
-            count -= 8;
-        }
-        doff = didx * 8;
-        soff = sidx * 8;
-    }
-
-    while (count > 8 && (doff & 7) != 0) {
-        bool bit = bitmap_get(s, slen, soff++);
-        bitmap_set(d, dlen, doff++, bit);
-        count--;
-    }
-
-    if (count > 8) {
-        uint8_t skew = soff % 8;
-        uint32_t didx = doff / 8;
-        uint32_t sidx = soff / 8;
-        while (count > 8 && didx < dlen && sidx < slen) {
-            d[didx] = ((s[sidx] << skew) | (s[sidx + 1] >> (8 - skew)));
-            sidx++;
-            didx++;
-            soff += 8;
-            doff += 8;
-            count -= 8;
-        }
-    }
-
-    while (count) {
-        bool bit = bitmap_get(s, slen, soff++);
-        bitmap_set(d, dlen, doff++, bit);
-        count--;
-    }
+    bit_cursor_copy(d, dlen, doff, s, slen, soff, count);
 }
 
 void bitmap_reverse_bytes_bits(uint8_t *p, uint32_t len) {
-    for (uint32_t j = 0; j < len; j++) {
-        uint32_t b = p[j];
-        b = (b & 0xf0) >> 4 | (b & 0x0f) << 4;
-        b = (b & 0xcc) >> 2 | (b & 0x33) << 2;
-        b = (b & 0xaa) >> 1 | (b & 0x55) << 1;
-        p[j] = b;
-    }
+    uint32_t j = 0;
+    for (; j + 4 <= len; j += 4)
+        bitops_store_be32(p + j, bitops_rbit8x4(bitops_load_be32(p + j)));
+    for (; j < len; j++)
+        p[j] = bitops_rbit32(p[j]) >> 24;
 }
 
 bool bitmap_match_bits(uint8_t *b, uint32_t blen, uint32_t bitpos, const char *bits) {
@@ -273,7 +769,62 @@ bool bitmap_match_bits(uint8_t *b, uint32_t blen, uint32_t bitpos, const char *b
     return true;
 }
 
+/* Compile the "0101..." pattern 'bits' into 'p'. Returns false if the
+ * pattern is too long to be compiled. */
+bool bitmap_pattern_compile(BitPattern *p, const char *bits) {
+    size_t len = strlen(bits);
+    if (len > BIT_PATTERN_MAX_LEN) return false;
+    p->value = 0;
+    p->len = len;
+    for (size_t j = 0; j < len; j++)
+        p->value = (p->value << 1) | (bits[j] == '1');
+    p->mask = len == 64 ? UINT64_MAX : (((uint64_t)1 << len) - 1);
+    return true;
+}
+
+/* Byte 'i' of the bitmap, or zero past its end like bitmap_get(). */
+static inline uint8_t bitmap_byte(uint8_t *b, uint32_t blen, uint32_t i) {
+    return i < blen ? b[i] : 0;
+}
+
+/* Return the first offset from 'startpos' where the compiled pattern 'p'
+ * matches, looking at most at 'maxbits' offsets. The bitmap is read a byte
+ * at a time into a 64 bit window, and at each offset the window, plus
+ * the bits of the next byte shifted in, is compared with the pattern. */
+uint32_t bitmap_seek_pattern(uint8_t *b, uint32_t blen, uint32_t startpos, uint32_t maxbits, const BitPattern *p) {
+    uint32_t endpos = startpos + blen * 8;
+    uint32_t end2 = startpos + maxbits;
+    if (end2 < endpos) endpos = end2;
+    if (startpos >= endpos) return BITMAP_SEEK_NOT_FOUND;
+    if (p->len == 0) return startpos;
+
+    uint32_t byte = startpos / 8;
+    uint32_t skew = startpos & 7;
+    uint32_t shift = 64 - p->len;
+    uint64_t win = 0;
+    for (uint32_t j = 0; j < 8; j++)
+        win = (win << 8) | bitmap_byte(b, blen, byte + j);
+    uint8_t next = bitmap_byte(b, blen, byte + 8);
+
+    for (uint32_t j = startpos; j < endpos; j++) {
+        uint64_t w = skew ? (win << skew) | (next >> (8 - skew)) : win;
+        if (((w >> shift) & p->mask) == (p->value & p->mask)) return j;
+        if (++skew == 8) {
+            skew = 0;
+            byte++;
+            win = (win << 8) | next;
+            next = bitmap_byte(b, blen, byte + 8);
+        }
+    }
+    return BITMAP_SEEK_NOT_FOUND;
+}
+
 uint32_t bitmap_seek_bits(uint8_t *b, uint32_t blen, uint32_t startpos, uint32_t maxbits, const char *bits) {
+    BitPattern p;
+    if (bitmap_pattern_compile(&p, bits))
+        return bitmap_seek_pattern(b, blen, startpos, maxbits, &p);
+
+    /* Too long to compile: match it bit by bit. */
     uint32_t endpos = startpos + blen * 8;
     uint32_t end2 = startpos + maxbits;
     if (end2 < endpos) endpos = end2;
@@ -282,6 +833,156 @@ uint32_t bitmap_seek_bits(uint8_t *b, uint32_t blen, uint32_t startpos, uint32_t
     return BITMAP_SEEK_NOT_FOUND;
 }
 
+/* =============================================================================
+ * Sync matcher
+ *
+ * The sync patterns of all the decoders are compiled once into a single
+ * matcher, that finds the first occurrence of each of them in one pass
+ * over the bitmap. At every offset, only the patterns whose first (up to)
+ * eight bits agree with the next byte of the bitmap are compared, using
+ * a table indexed by that byte, so the cost of a pass depends very little
+ * on the number of registered patterns.
+ *
+ * Decoders with long preambles can accept up to sync_max_errors flipped
+ * bits. For their patterns the table also selects the bytes that differ
+ * from the pattern head in that many bits or less, and the comparison
+ * counts the bits set in the XOR of the window and the pattern. Besides
+ * the first exact match, the matcher reports the offsets with the fewest
+ * errors before it: decoders are tried at the exact matches first, and
+ * at the approximate ones only if that fails. Preambles are repetitive,
+ * so with a flipped bit a shifted offset often has as few errors as the
+ * right one: up to SYNC_MAX_APPROX offsets are kept, the first ones and
+ * the last one.
+ * ===========================================================================*/
+
+#define SYNC_MAX_PATTERNS 32
+#define SYNC_MAX_APPROX 4
+
+static struct {
+    bool ready;
+    uint32_t numpat;
+    BitPattern pat[SYNC_MAX_PATTERNS];
+    uint8_t first[COUNT_OF(Decoders)]; /* First pattern of each decoder. */
+    uint32_t patterns[COUNT_OF(Decoders)]; /* Patterns of each decoder. */
+    uint32_t prefix[256];   /* Patterns that may match, by first byte. */
+    uint32_t inverted;      /* Patterns of decoders with allow_inverted. */
+    uint8_t maxerr[SYNC_MAX_PATTERNS]; /* Bit errors accepted. */
+} SyncMatcher;
+
+/* Result of a sync_matcher_run(), by pattern. Offsets of approximate
+ * matches fit 16 bits, since the bitmap is at most DECODE_ARENA_SIZE. */
+typedef struct {
+    uint32_t exact[SYNC_MAX_PATTERNS];  /* First exact match. */
+    uint16_t approx[SYNC_MAX_PATTERNS][SYNC_MAX_APPROX]; /* Matches with the
+                                           fewest errors before it. */
+    uint8_t numapprox[SYNC_MAX_PATTERNS];
+    uint8_t errors[SYNC_MAX_PATTERNS];  /* Bit errors at 'approx'. */
+} SyncMatches;
+
+/* Compile the sync patterns of all the decoders. */
+static void sync_matcher_init(void) {
+    SyncMatcher.numpat = 0;
+    SyncMatcher.inverted = 0;
+    memset(SyncMatcher.prefix, 0, sizeof(SyncMatcher.prefix));
+    memset(SyncMatcher.patterns, 0, sizeof(SyncMatcher.patterns));
+    for (uint32_t j = 0; Decoders[j]; j++) {
+        furi_check(j < 32); /* Decoders are selected by 32 bit masks. */
+        SyncMatcher.first[j] = SyncMatcher.numpat;
+        const char **sync = Decoders[j]->sync;
+        for (uint32_t k = 0; sync && sync[k]; k++) {
+            uint32_t n = SyncMatcher.numpat++;
+            furi_check(k < DECODER_MAX_SYNC && n < SYNC_MAX_PATTERNS);
+            BitPattern *p = &SyncMatcher.pat[n];
+            furi_check(bitmap_pattern_compile(p, sync[k]));
+            if (Decoders[j]->allow_inverted)
+                SyncMatcher.inverted |= 1UL << n;
+            SyncMatcher.maxerr[n] = Decoders[j]->sync_max_errors;
+            SyncMatcher.patterns[j] |= 1UL << n;
+
+            /* Every byte starting with the first bits of the pattern
+             * (all of them, if it is shorter than a byte), give or take
+             * the accepted errors, selects it. */
+            uint32_t plen = p->len < 8 ? p->len : 8;
+            uint32_t head = p->value >> (p->len - plen);
+            for (uint32_t byte = 0; byte < 256; byte++)
+                if (bitops_popcount32((byte >> (8 - plen)) ^ head) <=
+                    SyncMatcher.maxerr[n])
+                    SyncMatcher.prefix[byte] |= 1UL << n;
+        }
+    }
+    SyncMatcher.ready = true;
+}
+
+/* Set m->exact[] to the offset of the first match of each pattern in the
+ * first 'numbits' bits of the bitmap, or to BITMAP_SEEK_NOT_FOUND, with
+ * the same semantics as bitmap_seek_bits() called from offset zero. For
+ * patterns that accept errors, m->approx[], m->numapprox[] and m->errors[]
+ * are set to the offsets before that with the fewest errors, if any. Only
+ * the patterns in the 'select' bitmask are searched, the others are
+ * reported as not found. */
+static void sync_matcher_run(uint8_t *b, uint32_t blen, uint32_t numbits,
+                             uint32_t select, SyncMatches *m)
+{
+    uint32_t pending = 0;
+    for (uint32_t n = 0; n < SyncMatcher.numpat; n++) {
+        m->exact[n] = BITMAP_SEEK_NOT_FOUND;
+        m->numapprox[n] = 0;
+        m->errors[n] = 0;
+        if (!(select & (1UL << n))) continue;
+        if (SyncMatcher.pat[n].len) pending |= 1UL << n;
+        else m->exact[n] = 0;
+    }
+
+    uint32_t endpos = blen * 8 < numbits ? blen * 8 : numbits;
+    if (endpos > UINT16_MAX) endpos = UINT16_MAX;
+    uint32_t byte = 0, skew = 0;
+    uint64_t win = 0;
+    for (uint32_t j = 0; j < 8; j++)
+        win = (win << 8) | bitmap_byte(b, blen, j);
+    uint8_t next = bitmap_byte(b, blen, 8);
+
+    for (uint32_t j = 0; j < endpos && pending; j++) {
+        uint64_t w = skew ? (win << skew) | (next >> (8 - skew)) : win;
+        uint32_t cand = SyncMatcher.prefix[w >> 56] & pending;
+        while (cand) {
+            uint32_t n = bitops_ctz32(cand);
+            cand &= cand - 1;
+            BitPattern *p = &SyncMatcher.pat[n];
+            uint64_t diff = ((w >> (64 - p->len)) ^ p->value) & p->mask;
+            if (diff == 0) {
+                m->exact[n] = j;
+                pending &= ~(1UL << n);
+                continue;
+            }
+
+            /* Approximate match: there are at most 'maxerr' errors if
+             * clearing that many of the lowest set bits leaves nothing. */
+            uint32_t maxerr = SyncMatcher.maxerr[n];
+            if (maxerr == 0) continue;
+            uint64_t rest = diff;
+            for (uint32_t e = 0; e < maxerr && rest; e++) rest &= rest - 1;
+            if (rest) continue;
+            uint32_t e = bitops_popcount64(diff);
+            if (m->numapprox[n] == 0 || e < m->errors[n]) {
+                m->numapprox[n] = 0;
+                m->errors[n] = e;
+            } else if (e > m->errors[n]) {
+                continue;
+            }
+            uint32_t slot = m->numapprox[n];
+            if (slot == SYNC_MAX_APPROX) slot--; /* Replace the last one. */
+            else m->numapprox[n]++;
+            m->approx[n][slot] = j;
+        }
+        if (++skew == 8) {
+            skew = 0;
+            byte++;
+            win = (win << 8) | next;
+            next = bitmap_byte(b, blen, byte + 8);
+        }
+    }
+}
+
 bool bitmap_match_bitmap(uint8_t *b1, uint32_t b1len, uint32_t b1off,
                          uint8_t *b2, uint32_t b2len, uint32_t b2off,
                          uint32_t cmplen)
@@ -310,6 +1011,9 @@ void bitmap_set_pattern(uint8_t *b, uint32_t blen, uint32_t off, const char *pat
     }
 }
 
+/* Sample the signal into bits at the given rate. Before rounding, each
+ * pulse is corrected by the high/low bias of the signal, so that a pulse
+ * of N symbols is compared against N periods of its own level. */
 uint32_t convert_signal_to_bits(uint8_t *b, uint32_t blen, RawSamplesBuffer *s, uint32_t idx, uint32_t count, uint32_t rate) {
     if (rate == 0) return 0;
     uint32_t bitpos = 0;
@@ -318,20 +1022,111 @@ uint32_t convert_signal_to_bits(uint8_t *b, uint32_t blen, RawSamplesBuffer *s,
         bool level;
         raw_samples_get(s, j + idx, &level, &dur);
 
+        int32_t corrected = level ? (int32_t)dur - s->level_bias :
+                                    (int32_t)dur + s->level_bias;
+        dur = corrected > 0 ? (uint32_t)corrected : 0;
+
         uint32_t numbits = dur / rate;
         uint32_t rest = dur % rate;
         if (rest > rate / 2) numbits++;
-        if (numbits > 1024) numbits = 1024;
+        if (numbits > DECODE_MAX_PULSE_BITS) numbits = DECODE_MAX_PULSE_BITS;
         if (numbits == 0) continue;
 
-        while (numbits--) bitmap_set(b, blen, bitpos++, level);
+        bitmap_set_run(b, blen, bitpos, numbits, level);
+        bitpos += numbits;
     }
     return bitpos;
 }
 
+/* Manchester lookup table: for each byte of line code (four symbols), the
+ * low nibble holds the first bit of every symbol, that is the decoded data
+ * for the "01" = 0, "10" = 1 convention, and the high nibble how many
+ * symbols, from the left, are valid (not "00" or "11"). */
+static uint8_t ManchesterLUT[256];
+static bool ManchesterLUTReady = false;
+
+static void manchester_lut_init(void) {
+    for (uint32_t byte = 0; byte < 256; byte++) {
+        uint32_t data = 0, valid = 0;
+        for (int sym = 0; sym < 4; sym++) {
+            uint32_t x = (byte >> (7 - sym * 2)) & 1;
+            uint32_t y = (byte >> (6 - sym * 2)) & 1;
+            if (x == y) break;
+            data |= x << (3 - sym);
+            valid++;
+        }
+        ManchesterLUT[byte] = (valid << 4) | data;
+    }
+    ManchesterLUTReady = true;
+}
+
+/* Return the 8 bits of the bitmap starting at 'bitpos', that must be
+ * inside the 'blen' bytes of the bitmap. */
+static inline uint8_t bitmap_get_byte(uint8_t *b, uint32_t blen, uint32_t bitpos) {
+    uint32_t byte = bitpos / 8;
+    uint32_t skew = bitpos & 7;
+    if (skew == 0) return b[byte];
+    uint8_t next = byte + 1 < blen ? b[byte + 1] : 0;
+    return (b[byte] << skew) | (next >> (8 - skew));
+}
+
+/* Manchester fast path of convert_from_line_code(): decodes four symbols
+ * per table lookup, writing a nibble at a time into 'buf'. 'invert' is
+ * 0 for the "01" = 0 convention and 0xf for "10" = 0. Stops at the first
+ * invalid symbol, when 'buf' is full, or when less than a byte of line
+ * code is left. Updates '*off' and returns the number of bits decoded,
+ * that is always a multiple of four unless an invalid symbol was found
+ * (in which case '*error' is set). */
+static uint32_t manchester_decode_fast(uint8_t *buf, uint64_t buflen,
+                                       uint8_t *bits, uint32_t numbytes,
+                                       uint32_t *off, uint8_t invert,
+                                       bool *error)
+{
+    if (!ManchesterLUTReady) manchester_lut_init();
+    uint32_t len = numbytes * 8;
+    uint32_t decoded = 0;
+    *error = false;
+
+    while (*off + 8 <= len && decoded / 8 < buflen) {
+        uint8_t e = ManchesterLUT[bitmap_get_byte(bits, numbytes, *off)];
+        uint32_t valid = e >> 4;
+        uint8_t data = (e ^ invert) & 0xf;
+
+        if (valid == 4) {
+            uint8_t *p = buf + decoded / 8;
+            if (decoded & 4)
+                *p = (*p & 0xf0) | data;
+            else
+                *p = (*p & 0x0f) | (data << 4);
+        } else {
+            for (uint32_t j = 0; j < valid; j++)
+                bitmap_set(buf, buflen, decoded + j, (data >> (3 - j)) & 1);
+            *error = true;
+        }
+        decoded += valid;
+        *off += valid * 2;
+        if (*error) break;
+    }
+    return decoded;
+}
+
 uint32_t convert_from_line_code(uint8_t *buf, uint64_t buflen, uint8_t *bits, uint32_t len, uint32_t off, const char *zero_pattern, const char *one_pattern)
 {
     uint32_t decoded = 0;
+
+    /* Manchester, in one of the two conventions, has a table driven fast
+     * path. The generic loop below handles the last few symbols, and line
+     * codes with other patterns. */
+    bool manchester_01 = !strcmp(zero_pattern, "01") && !strcmp(one_pattern, "10");
+    bool manchester_10 = !strcmp(zero_pattern, "10") && !strcmp(one_pattern, "01");
+    if (manchester_01 || manchester_10) {
+        bool error;
+        uint8_t invert = manchester_10 ? 0xf : 0;
+        decoded = manchester_decode_fast(buf, buflen, bits, len, &off,
+                                         invert, &error);
+        if (error || decoded / 8 == buflen) return decoded;
+    }
+
     len *= 8;
     while (off < len) {
         bool bitval;
@@ -350,9 +1145,84 @@ uint32_t convert_from_line_code(uint8_t *buf, uint64_t buflen, uint8_t *bits, ui
     return decoded;
 }
 
+/* Differential Manchester lookup table, indexed by the previous line level
+ * (bit 8) and a byte of line code (four symbols). Every symbol is a pair
+ * of bits 'xy': it is invalid if x equals the previous level, otherwise it
+ * decodes to 1 if x == y, and y becomes the previous level. Each entry
+ * holds the data bits of the valid symbols, left aligned in bits 0-3, the
+ * number of valid symbols from the left in bits 4-6, and the new previous
+ * level in bit 7. */
+static uint8_t DiffManchesterLUT[512];
+static bool DiffManchesterLUTReady = false;
+
+static void diff_manchester_lut_init(void) {
+    for (uint32_t idx = 0; idx < 512; idx++) {
+        uint32_t prev = idx >> 8;
+        uint32_t data = 0, valid = 0;
+        for (int sym = 0; sym < 4; sym++) {
+            uint32_t x = (idx >> (7 - sym * 2)) & 1;
+            uint32_t y = (idx >> (6 - sym * 2)) & 1;
+            if (x == prev) break;
+            data |= (x == y) << (3 - sym);
+            prev = y;
+            valid++;
+        }
+        DiffManchesterLUT[idx] = (prev << 7) | (valid << 4) | data;
+    }
+    DiffManchesterLUTReady = true;
+}
+
+/* Table driven differential Manchester decoding of the symbols starting
+ * at '*off', given the previous line level '*prev'. Decodes four symbols
+ * per lookup, appending the bits to 'buf' starting at 'decoded', and
+ * stops at the first invalid symbol (setting '*error'), when less than
+ * four bits are left before 'maxbits', or when less than a byte of line
+ * code is left. Updates '*off' and '*prev' to continue from there, and
+ * returns the new number of decoded bits. Bits past the end of 'buf' are
+ * discarded, like bitmap_set() does. */
+static uint32_t diff_manchester_decode_fast(uint8_t *buf, uint32_t buflen,
+    uint8_t *bits, uint32_t numbytes, uint32_t *off, bool *prev,
+    uint32_t decoded, uint32_t maxbits, bool *error)
+{
+    if (!DiffManchesterLUTReady) diff_manchester_lut_init();
+    uint32_t len = numbytes * 8;
+    *error = false;
+
+    while (*off + 8 <= len && decoded + 4 <= maxbits) {
+        uint32_t idx = (*prev << 8) | bitmap_get_byte(bits, numbytes, *off);
+        uint8_t e = DiffManchesterLUT[idx];
+        uint32_t valid = (e >> 4) & 7;
+        uint8_t data = e & 0xf;
+
+        if (valid == 4 && (decoded & 3) == 0 && decoded / 8 < buflen) {
+            uint8_t *p = buf + decoded / 8;
+            if (decoded & 4)
+                *p = (*p & 0xf0) | data;
+            else
+                *p = (*p & 0x0f) | (data << 4);
+        } else {
+            for (uint32_t j = 0; j < valid; j++)
+                bitmap_set(buf, buflen, decoded + j, (data >> (3 - j)) & 1);
+        }
+        decoded += valid;
+        *off += valid * 2;
+        *prev = e >> 7;
+        if (valid < 4) {
+            *error = true;
+            break;
+        }
+    }
+    return decoded;
+}
+
 uint32_t convert_from_diff_manchester(uint8_t *buf, uint64_t buflen, uint8_t *bits, uint32_t len, uint32_t off, bool previous)
 {
-    uint32_t decoded = 0;
+    bool error;
+    uint32_t decoded = diff_manchester_decode_fast(buf, buflen, bits, len,
+        &off, &previous, 0, buflen * 8, &error);
+    if (error || decoded / 8 == buflen) return decoded;
+
+    /* Decode the last symbols one by one. */
     len *= 8;
     for (uint32_t j = off; j < len; j += 2) {
         bool b0 = bitmap_get(bits, len, j);
@@ -379,6 +1249,13 @@ uint32_t diff_manchester_decode(
     if (off >= limit) return 0;
     bool bit = bitmap_get(bits, numbytes, off++);
 
+    /* Most of the symbols go through the table, the remaining ones are
+     * decoded one by one below. */
+    bool error;
+    decoded = diff_manchester_decode_fast(buf, buflen, bits, numbytes,
+        &off, &bit, 0, max_bits, &error);
+    if (error) return decoded;
+
     while (decoded < max_bits && off < limit) {
         bool bit2 = bitmap_get(bits, numbytes, off++);
         if (bit == bit2) break; /* No mid-bit transition: error. */
@@ -402,6 +1279,114 @@ void free_msg_info(ProtoViewMsgInfo *i) {
     free(i);
 }
 
+/* =============================================================================
+ * Adaptive decoder order
+ *
+ * On a given street most frames come from a few protocols, so each preset
+ * keeps its own decoder order, sorted by recent hits: the decoders that
+ * succeed are tried first, and fewer calls are spent on the others. All
+ * the decoders stay in the order, so they are always reachable. Two
+ * decoders whose sync patterns can match the same bits (one contains the
+ * other) could both accept a frame: for them the order of Decoders[] is
+ * kept regardless of hits, so which one wins stays deterministic.
+ * ===========================================================================*/
+
+static struct {
+    bool ready;
+    uint32_t before[COUNT_OF(Decoders)]; /* Decoders that must be tried
+                                            before each decoder. */
+} DecoderOverlap;
+
+/* Return true if decoders 'a' and 'b' may accept the same frames: they
+ * receive the same modulation at some common rate, and a sync pattern of
+ * one contains a sync pattern of the other. */
+static bool decoders_overlap(const ProtoViewDecoder *a, const ProtoViewDecoder *b) {
+    if (a->mod_class && b->mod_class && !(a->mod_class & b->mod_class))
+        return false;
+    if (a->symbol_max_us && b->symbol_max_us &&
+        (a->symbol_max_us < b->symbol_min_us ||
+         b->symbol_max_us < a->symbol_min_us))
+        return false;
+    if (!a->sync || !a->sync[0] || !b->sync || !b->sync[0]) return true;
+    for (uint32_t i = 0; a->sync[i]; i++) {
+        for (uint32_t k = 0; b->sync[k]; k++) {
+            if (strstr(a->sync[i], b->sync[k]) || strstr(b->sync[k], a->sync[i]))
+                return true;
+        }
+    }
+    return false;
+}
+
+/* Set DecoderOverlap.before[] to the decoders each one must follow: the
+ * ones before it in Decoders[] that overlap with it, and transitively the
+ * ones those must follow. */
+static void decoder_overlap_init(void) {
+    for (uint32_t j = 0; Decoders[j]; j++) {
+        DecoderOverlap.before[j] = 0;
+        for (uint32_t i = 0; i < j; i++)
+            if (decoders_overlap(Decoders[i], Decoders[j]))
+                DecoderOverlap.before[j] |= (1UL << i) |
+                                            DecoderOverlap.before[i];
+    }
+    DecoderOverlap.ready = true;
+}
+
+/* Sort the decoders of 'preset' so that the expected number of calls
+ * before the right decoder is small. A decoder can only be placed after
+ * the overlapping ones that precede it in Decoders[], so placing it costs
+ * one call for it and for each of them not placed yet. Greedily, the
+ * decoder with the most hits per call of that cost is chosen, and its
+ * first missing predecessor (or itself) is placed. With no hits the
+ * order is Decoders[]. */
+static void decoder_rank_sort(ProtoViewDecoderRank *rank, uint32_t preset) {
+    uint32_t numdecoders = COUNT_OF(Decoders) - 1;
+    uint16_t *hits = rank->hits[preset];
+    uint32_t all = (numdecoders == 32) ? UINT32_MAX : (1UL << numdecoders) - 1;
+    uint32_t placed = 0;
+    for (uint32_t n = 0; n < numdecoders; n++) {
+        uint32_t best = numdecoders, bestcost = 0;
+        for (uint32_t k = 0; k < numdecoders; k++) {
+            if (placed & (1UL << k) || hits[k] == 0) continue;
+            uint32_t cost = bitops_popcount32(
+                (DecoderOverlap.before[k] | (1UL << k)) & ~placed);
+            if (best == numdecoders || hits[k] * bestcost > hits[best] * cost) {
+                best = k;
+                bestcost = cost;
+            }
+        }
+        uint32_t pending = best == numdecoders ? all & ~placed :
+                           (DecoderOverlap.before[best] | (1UL << best)) & ~placed;
+        uint32_t j = bitops_ctz32(pending);
+        rank->order[preset][n] = j;
+        placed |= 1UL << j;
+    }
+}
+
+void decoder_rank_init(ProtoViewDecoderRank *rank) {
+    if (!DecoderOverlap.ready) decoder_overlap_init();
+    furi_check(COUNT_OF(Decoders) - 1 <= RANK_MAX_DECODERS);
+    memset(rank, 0, sizeof(*rank));
+    for (uint32_t p = 0; p < RANK_MAX_PRESETS; p++)
+        decoder_rank_sort(rank, p);
+}
+
+/* Account a frame decoded by 'decoder' with 'preset', and update the
+ * order of that preset. */
+void decoder_rank_hit(ProtoViewDecoderRank *rank, uint32_t preset, const ProtoViewDecoder *decoder) {
+    if (preset >= RANK_MAX_PRESETS) return;
+    uint32_t j;
+    for (j = 0; Decoders[j] && Decoders[j] != decoder; j++);
+    if (Decoders[j] == NULL) return;
+
+    uint16_t *hits = rank->hits[preset];
+    if (hits[j] < UINT16_MAX) hits[j]++;
+    if (++rank->decodes[preset] >= RANK_DECAY_HITS) {
+        for (uint32_t i = 0; i < RANK_MAX_DECODERS; i++) hits[i] /= 2;
+        rank->decodes[preset] = 0;
+    }
+    decoder_rank_sort(rank, preset);
+}
+
 void init_msg_info(ProtoViewMsgInfo *i, ProtoViewApp *app) {
     UNUSED(app);
     memset(i, 0, sizeof(ProtoViewMsgInfo));
@@ -409,50 +1394,648 @@ void init_msg_info(ProtoViewMsgInfo *i, ProtoViewApp *app) {
     i->fieldset = fieldset_new();
 }
 
-bool decode_signal(RawSamplesBuffer *s, uint64_t len, ProtoViewMsgInfo *info) {
-    uint32_t bitmap_bits_size = 4096 * 8;
-    uint32_t bitmap_size = bitmap_bits_size / 8;
+/* Copy the pulses of the decoded message from the bitmap to info->bits,
+ * so that it can be shown and saved after the bitmap is reused. */
+static void msg_info_copy_bits(ProtoViewMsgInfo *info, uint8_t *bitmap,
+                               uint32_t bitmap_size)
+{
+    if (info->pulses_count == 0) return;
+    info->bits_bytes = (info->pulses_count + 7) / 8;
+    info->bits = malloc(info->bits_bytes);
+    bitmap_copy(info->bits, info->bits_bytes, 0, bitmap, bitmap_size,
+                info->start_off, info->pulses_count);
+}
+
+/* Called by decoders when the CRC8 of the 'len' bytes of 'data', stored
+ * in data[len], doesn't match. If the decode pipeline allows it (see
+ * TPMS_CRC_FIX) and the mismatch is the one of a single bit error, the
+ * bit is corrected in 'data', counted in info->fixed_bits, and true is
+ * returned: the decoder can go on with the corrected bytes. */
+bool decoder_fix_crc8(ProtoViewMsgInfo *info, uint8_t *data, uint32_t len,
+                      uint8_t init, uint8_t poly)
+{
+    if (!info->fix_errors) return false;
+    int pos = crc8_fix_single_bit(data, len, init, poly);
+    if (pos < 0) return false;
+    LOG_D("CRC8: corrected bit %d of %lu bytes", pos, len);
+    info->fixed_bits++;
+    return true;
+}
+
+/* Return 1 if the field 'name' of 'fs', multiplied by 'scale', is within
+ * the range of values real sensors report, -1 if it is outside it, and 0
+ * if the field is not present or not a number. */
+static int32_t field_plausible(ProtoViewFieldSet *fs, const char *name,
+                               float scale, float min, float max)
+{
+    ProtoViewField *f = fieldset_find(fs, name);
+    if (f == NULL) return 0;
+    float v;
+    if (f->type == FieldTypeFloat) v = f->fvalue;
+    else if (f->type == FieldTypeSignedInt) v = f->value;
+    else if (f->type == FieldTypeUnsignedInt) v = f->uvalue;
+    else return 0;
+    v *= scale;
+    return v >= min && v <= max ? 1 : -1;
+}
+
+/* Count the pressure and temperature fields of 'fs' that are plausible
+ * in '*good', and the ones that are not in '*bad'. */
+static void msg_check_fields(ProtoViewFieldSet *fs, uint32_t *good,
+                             uint32_t *bad)
+{
+    /* Pressure in kPa, up to ~100 psi; temperature in Celsius. */
+    int32_t checks[3] = {
+        field_plausible(fs, "Pressure kpa", 1, 0, 700),
+        field_plausible(fs, "Pressure psi", 6.894757f, 0, 700),
+        field_plausible(fs, "Temperature C", 1, -40, 125),
+    };
+    *good = *bad = 0;
+    for (uint32_t k = 0; k < COUNT_OF(checks); k++) {
+        if (checks[k] > 0) (*good)++;
+        if (checks[k] < 0) (*bad)++;
+    }
+}
+
+/* =============================================================================
+ * Evaluate-all decoding
+ *
+ * Some protocols can accept the same run: sync patterns that contain one
+ * another, or symbol times that are multiples of each other. In the
+ * default mode the first decoder to accept a run wins, so the order of
+ * Decoders[] decides. In evaluate-all mode every eligible decoder is run,
+ * and the results are ranked by how much evidence backs them.
+ * ===========================================================================*/
+
+#define EVAL_SCORE_CHECK_BIT 4      /* Per bit of frame check. */
+#define EVAL_SCORE_SYNC_ERROR 8     /* Per sync bit error, on top of the
+                                       bit not counted as matched. */
+#define EVAL_SCORE_PLAUSIBLE 8      /* Per field within sensor limits. */
+#define EVAL_SCORE_IMPLAUSIBLE 32   /* Per field outside them. */
+#define EVAL_SCORE_FIXED_BIT 32     /* Per bit corrected by the CRC. */
+
+typedef struct {
+    ProtoViewDecodeCtx *ctx;
+    ProtoViewMsgInfo *best;     /* decode_signal() result, if 'found'. */
+    bool found;
+    int32_t best_score;
+    uint32_t best_rate;
+    int32_t best_match;         /* Index in ctx->matches, or -1. */
+} DecodeEval;
+
+/* Score a message decoded by 'd': the strength of its frame check, the
+ * sync bits matched (the longest pattern found, minus a penalty for each
+ * bit error accepted in it), whether pressure and temperature are within
+ * what a tire can report, and the bits corrected. Higher is better. */
+static int32_t decode_eval_score(const ProtoViewDecoder *d,
+                                 ProtoViewMsgInfo *info)
+{
+    int32_t score = d->check_bits * EVAL_SCORE_CHECK_BIT;
+
+    int32_t sync = 0;
+    for (uint32_t k = 0; d->sync && d->sync[k]; k++) {
+        if (info->sync_off[k] == BITMAP_SEEK_NOT_FOUND) continue;
+        int32_t matched = (int32_t)strlen(d->sync[k]) -
+                          info->sync_errors[k] * (1 + EVAL_SCORE_SYNC_ERROR);
+        if (matched > sync) sync = matched;
+    }
+    score += sync;
+
+    uint32_t good, bad;
+    msg_check_fields(info->fieldset, &good, &bad);
+    score += good * EVAL_SCORE_PLAUSIBLE - bad * EVAL_SCORE_IMPLAUSIBLE;
+    score -= info->fixed_bits * EVAL_SCORE_FIXED_BIT;
+    return score;
+}
+
+/* Called when decoder 'j' accepted the run in evaluate-all mode: 'trial'
+ * holds its result. Record the match, and make it the result if it scores
+ * better than the previous ones. 'trial' is then reset for the next
+ * decoder. */
+static void decode_eval_offer(DecodeEval *eval, uint32_t j,
+                              ProtoViewMsgInfo *trial, uint32_t rate,
+                              uint8_t *bitmap, uint32_t bitmap_size)
+{
+    ProtoViewDecodeCtx *ctx = eval->ctx;
+    int32_t score = decode_eval_score(Decoders[j], trial);
+    bool better = !eval->found || score > eval->best_score;
 
-    uint32_t before_samples = 32;
-    uint32_t after_samples = 100;
+    int32_t match = -1;
+    if (ctx->nummatches < DECODE_MAX_MATCHES) {
+        match = ctx->nummatches++;
+        ProtoViewDecodeMatch *dm = &ctx->matches[match];
+        dm->decoder = j;
+        dm->inverted = trial->inverted;
+        dm->kept = false;
+        dm->score = score < INT16_MIN ? INT16_MIN :
+                    score > INT16_MAX ? INT16_MAX : score;
+        dm->rate = rate;
+    }
+    LOG_D("Evaluate-all: %s score %ld", Decoders[j]->name, score);
+
+    ProtoViewFieldSet *drop = trial->fieldset;
+    if (better) {
+        ProtoViewMsgInfo *best = eval->best;
+        drop = best->fieldset;
+        free(best->bits);
+        *best = *trial;
+        best->bits = NULL;
+        best->bits_bytes = 0;
+        best->short_pulse_dur = rate;
+        msg_info_copy_bits(best, bitmap, bitmap_size);
+        eval->found = true;
+        eval->best_score = score;
+        eval->best_rate = rate;
+        eval->best_match = match;
+    }
+    fieldset_free(drop);
+    memset(trial, 0, sizeof(*trial));
+    trial->fieldset = fieldset_new();
+}
+
+/* Return true if one of the sync patterns of decoder 'j' was found
+ * without errors, or if the decoder has none. */
+static bool sync_found_exact(SyncMatches *m, uint32_t j) {
+    const char **sync = Decoders[j]->sync;
+    if (sync == NULL || sync[0] == NULL) return true;
+    uint32_t first = SyncMatcher.first[j];
+    for (uint32_t k = 0; sync[k]; k++)
+        if (m->exact[first + k] != BITMAP_SEEK_NOT_FOUND) return true;
+    return false;
+}
+
+/* Return the decoders of the 'decoders' bitmask whose sync was found
+ * exactly. */
+static uint32_t synced_decoders(SyncMatches *m, uint32_t decoders,
+                                bool inverted)
+{
+    uint32_t synced = 0;
+    for (uint32_t j = 0; Decoders[j]; j++) {
+        if (!(decoders & (1UL << j))) continue;
+        if (inverted && !Decoders[j]->allow_inverted) continue;
+        if (sync_found_exact(m, j)) synced |= 1UL << j;
+    }
+    return synced;
+}
+
+/* Return the decoders of the 'synced' bitmask that can correct CRC
+ * errors: the ones worth a correction pass if nothing decodes, see
+ * TPMS_CRC_FIX. */
+static uint32_t fixable_decoders(uint32_t synced) {
+    uint32_t fixable = 0;
+    for (uint32_t j = 0; Decoders[j]; j++)
+        if ((synced & (1UL << j)) && Decoders[j]->crc_fix)
+            fixable |= 1UL << j;
+    return fixable;
+}
+
+/* Try the decoders in the 'decoders' bitmask on the bitmap, in the given
+ * 'order', given the sync pattern matches found by sync_matcher_run().
+ * When 'inverted' is true the bitmap holds the inverted signal, and only
+ * decoders with allow_inverted are tried. Returns true if one of them
+ * succeeded, setting info->decoder. With 'eval' set (evaluate-all mode)
+ * each success is passed to decode_eval_offer() instead, and the other
+ * decoders are still tried. With 'fix' set the decoders may correct a
+ * CRC error, and are only called at their exact sync matches: a corrected
+ * frame is only accepted from one of the sensors in 'fix', and with
+ * plausible fields. The calls are added to '*calls'. */
+static bool try_decoders(uint8_t *bitmap, uint32_t bitmap_size, uint32_t bits,
+                         SyncMatches *m, uint32_t decoders,
+                         const uint8_t *order, bool inverted,
+                         TPMSSensorList *fix, uint32_t rate,
+                         ProtoViewMsgInfo *info, DecodeEval *eval,
+                         uint32_t *calls)
+{
+    bool decoded = false;
+
+    /* Decoders may rewrite the frame they accepted (Toyota fills in its
+     * preamble), so in evaluate-all mode the bitmap is restored after each
+     * success: the next decoders must score the signal as received. */
+    uint32_t saved = 0;
+    if (eval) {
+        saved = (bits + 7) / 8;
+        if (saved > bitmap_size) saved = bitmap_size;
+        memcpy(eval->ctx->eval_saved, bitmap, saved);
+    }
+
+    /* All the decoders are tried at their exact matches first, then at
+     * the approximate ones, that are before the exact ones or replace
+     * them if there are none: a decoder that accepts errors should not
+     * be called on a frame another decoder matches exactly. */
+    for (int phase = 0; phase < (fix ? 1 : 2); phase++) {
+        for (uint32_t n = 0; n < COUNT_OF(Decoders) - 1; n++) {
+            uint32_t j = order[n];
+            if (!(decoders & (1UL << j))) continue;
+            if (inverted && !Decoders[j]->allow_inverted) continue;
+
+            /* Skip decoders none of whose sync patterns was found. */
+            const char **sync = Decoders[j]->sync;
+            uint32_t first = SyncMatcher.first[j];
+            uint32_t approx = 0;
+            for (uint32_t k = 0; sync && sync[k]; k++) {
+                if (m->numapprox[first + k] > approx)
+                    approx = m->numapprox[first + k];
+            }
+            if (phase == 0 && !sync_found_exact(m, j)) continue;
+
+            uint32_t from = phase == 0 ? 0 : 1;
+            uint32_t to = phase == 0 ? 0 : approx;
+            for (uint32_t attempt = from; attempt <= to; attempt++) {
+                for (uint32_t k = 0; sync && sync[k]; k++) {
+                    uint32_t p = first + k;
+                    bool use_approx = attempt > 0 && attempt <= m->numapprox[p];
+                    info->sync_off[k] = use_approx ?
+                                        m->approx[p][attempt - 1] : m->exact[p];
+                    info->sync_errors[k] = use_approx ? m->errors[p] : 0;
+                }
+
+                TRACE(TraceDecoderMatch, j, info->sync_off[0]);
+                (*calls)++;
+                info->fix_errors = fix != NULL;
+                info->fixed_bits = 0;
+                bool ok = Decoders[j]->decode ?
+                    Decoders[j]->decode(bitmap, bitmap_size, bits, info) :
+                    proto_desc_decode(Decoders[j], bitmap, bitmap_size, bits,
+                                      info);
+                info->fix_errors = false;
+
+                /* A corrected frame needs a known sensor and plausible
+                 * fields: at least one, and none outside what a sensor can
+                 * report. */
+                if (ok && info->fixed_bits) {
+                    uint32_t good, bad;
+                    msg_check_fields(info->fieldset, &good, &bad);
+                    if (good == 0 || bad ||
+                        !tpms_sensor_known(fix, Decoders[j]->name,
+                                           info->fieldset))
+                    {
+                        fieldset_free(info->fieldset);
+                        info->fieldset = fieldset_new();
+                        info->fixed_bits = 0;
+                        ok = false;
+                    }
+                }
+                if (ok) {
+                    info->decoder = Decoders[j];
+                    info->inverted = inverted;
+                    TRACE(TraceDecodeOk, j, rate);
+                    if (eval == NULL) return true;
+                    decode_eval_offer(eval, j, info, rate, bitmap,
+                                      bitmap_size);
+                    memcpy(bitmap, eval->ctx->eval_saved, saved);
+                    /* Not again at its approximate matches. */
+                    decoders &= ~(1UL << j);
+                    decoded = true;
+                    break;
+                }
+            }
+        }
+    }
+    return decoded;
+}
+
+/* Convert the run of 'len' samples, plus the samples around it that the
+ * profile asks for, to bits at the given rate, and try the decoders in
+ * the '*decoders' bitmask on the result, in the given 'order'. Decoders
+ * whose frames are longer than the bits sampled are removed from
+ * '*decoders' before that. If none succeeds, the decoders that allow it
+ * are tried again on the inverted signal: the bitmap is inverted in
+ * place, and restored unless one of them succeeded. Returns true if a
+ * decoder succeeded, setting info->decoder and info->inverted. In
+ * evaluate-all mode ('eval' set) the inverted signal is tried anyway, and
+ * the bitmap always restored. With 'fix' set the decoders may correct CRC
+ * errors, see try_decoders(); otherwise the decoders worth a correction
+ * pass are stored in '*fixable', and the decoders whose sync was found
+ * are added to synced[0] (synced[1] for the inverted signal). The number
+ * of bits sampled is stored in '*numbits', and the decoder calls are added
+ * to '*calls'. */
+static bool decode_at_rate(uint8_t *bitmap, uint32_t bitmap_size,
+                           RawSamplesBuffer *s, uint64_t len, uint32_t rate,
+                           const ProtoViewDetectProfile *profile,
+                           uint32_t *decoders, const uint8_t *order,
+                           TPMSSensorList *fix, uint32_t *fixable,
+                           uint32_t *synced,
+                           ProtoViewMsgInfo *info, DecodeEval *eval,
+                           uint32_t *numbits, uint32_t *calls)
+{
+    uint32_t before_samples = profile->before_samples;
+    uint32_t after_samples = profile->after_samples;
 
-    uint8_t *bitmap = malloc(bitmap_size);
     uint32_t bits = convert_signal_to_bits(bitmap, bitmap_size, s,
-        -before_samples, len + before_samples + after_samples,
-        s->short_pulse_dur);
-
-    if (DEBUG_MSG) {
-        char *str = malloc(1024);
-        uint32_t j;
-        for (j = 0; j < bits && j < 1023; j++) {
-            str[j] = bitmap_get(bitmap, bitmap_size, j) ? '1' : '0';
+        -before_samples, len + before_samples + after_samples, rate);
+    *numbits = bits;
+
+    /* The decoders and the sync matcher only get the bytes the run was
+     * sampled into: past them the arena is all zeros anyway, and they
+     * don't need to scan it. */
+    uint32_t used = (bits + 7) / 8;
+    if (used < bitmap_size) bitmap_size = used;
+
+    if (!SyncMatcher.ready) sync_matcher_init();
+    uint32_t select = 0, inverted = 0;
+    for (uint32_t j = 0; Decoders[j]; j++) {
+        if (!(*decoders & (1UL << j))) continue;
+        if (bits < Decoders[j]->min_bits) {
+            *decoders &= ~(1UL << j);
+            continue;
         }
-        str[j] = 0;
-        FURI_LOG_E(TAG, "%lu bits sampled: %s", bits, str);
-        free(str);
+        select |= SyncMatcher.patterns[j];
+    }
+    if (*decoders == 0) return false;
+    inverted = select & SyncMatcher.inverted;
+
+    SyncMatches m;
+    sync_matcher_run(bitmap, bitmap_size, bits, select, &m);
+    if (fix == NULL) {
+        uint32_t found = synced_decoders(&m, *decoders, false);
+        *fixable = fixable_decoders(found);
+        synced[0] |= found;
+    }
+    bool decoded = try_decoders(bitmap, bitmap_size, bits, &m, *decoders,
+                                order, false, fix, rate, info, eval, calls);
+    if (decoded && eval == NULL) return true;
+
+    if (inverted == 0) return decoded;
+    bitmap_invert(bitmap, bitmap_size, bits);
+    sync_matcher_run(bitmap, bitmap_size, bits, inverted, &m);
+    if (fix == NULL) {
+        uint32_t found = synced_decoders(&m, *decoders, true);
+        *fixable |= fixable_decoders(found);
+        synced[1] |= found;
+    }
+    if (try_decoders(bitmap, bitmap_size, bits, &m, *decoders, order, true,
+                     fix, rate, info, eval, calls))
+    {
+        if (eval == NULL) return true;
+        decoded = true;
+    }
+    bitmap_invert(bitmap, bitmap_size, bits);
+    return decoded;
+}
+
+/* Return true if 'rate' is within 1/8 of one of the 'count' rates
+ * already in 'rates'. */
+static bool rate_listed(uint32_t *rates, uint32_t count, uint32_t rate) {
+    for (uint32_t j = 0; j < count; j++)
+        if (duration_delta(rates[j], rate) <= rates[j] / 8) return true;
+    return false;
+}
+
+bool decode_signal(ProtoViewApp *app, RawSamplesBuffer *s, uint64_t len, const ProtoViewDetectProfile *profile, uint32_t mod_class, const uint8_t *order, ProtoViewMsgInfo *info) {
+    ProtoViewDecodeCtx *ctx = &app->decode;
+    uint32_t bitmap_size = DECODE_ARENA_SIZE;
+    uint8_t *bitmap = ctx->bitmap;
+
+    /* Rate hypotheses, in the order they are tried: the measured short
+     * pulse, half of it, and the nominal rates of the decoders for this
+     * modulation between the two (or slightly above the measured one,
+     * for jittery runs). */
+    uint32_t measured = s->short_pulse_dur;
+    uint32_t nominal[COUNT_OF(Decoders)];
+    uint32_t numnominal = nominal_rates(mod_class, nominal);
+    uint32_t rates[2 + COUNT_OF(nominal)];
+    ProtoViewRateHyp hyps[COUNT_OF(rates)];
+    uint32_t numrates = 0;
+
+    rates[numrates] = measured;
+    hyps[numrates++] = RateHypMeasured;
+    if (measured / 2 && !rate_listed(rates, numrates, measured / 2)) {
+        rates[numrates] = measured / 2;
+        hyps[numrates++] = RateHypHalf;
+    }
+    for (uint32_t j = 0; j < numnominal; j++) {
+        uint32_t rate = nominal[j];
+        if (rate * 5 / 4 < measured / 2 || rate > measured * 5 / 4)
+            continue;
+        if (rate_listed(rates, numrates, rate)) continue;
+        rates[numrates] = rate;
+        hyps[numrates++] = RateHypNominal;
     }
 
-    int j = 0;
+    /* All the hypotheses, and all the calls, share the same bitmap. Since
+     * bits are only set up to the sampled length, the part written by the
+     * previous sampling is cleared before the next one, so that decoders
+     * scanning past the end of the signal can't see stale bits. */
+    uint32_t bits = 0;
+    uint32_t h;
     bool decoded = false;
-    while (Decoders[j]) {
-        decoded = Decoders[j]->decode(bitmap, bitmap_size, bits, info);
+    uint32_t numdecoders = COUNT_OF(Decoders) - 1;
+
+    /* In evaluate-all mode the decoders write to 'trial', and the best
+     * result is moved to 'info' by decode_eval_offer(). */
+    ProtoViewMsgInfo trial;
+    DecodeEval eval = {.ctx = ctx, .best = info, .best_match = -1};
+    DecodeEval *evalp = NULL;
+    ProtoViewMsgInfo *target = info;
+    ctx->nummatches = 0;
+    if (ctx->eval_all) {
+        if (ctx->eval_saved == NULL)
+            ctx->eval_saved = malloc(DECODE_ARENA_SIZE);
+        init_msg_info(&trial, app);
+        evalp = &eval;
+        target = &trial;
+    }
+    /* The second pass is the CRC correction one, see TPMS_CRC_FIX: if
+     * nothing decoded, the rates where a decoder able to correct errors
+     * found its sync exactly are sampled again, and only such decoders are
+     * called. So a corrected frame never wins over an exact one, and runs
+     * of noise, where no sync is found, don't cost a second pass. */
+    uint32_t fixable[COUNT_OF(rates)] = {0};
+    ctx->synced[0] = ctx->synced[1] = 0;
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        if (pass == 1 && (!ctx->crc_fix || ctx->known == NULL || decoded ||
+                          eval.found)) break;
+        for (h = 0; h < numrates; h++) {
+            /* Only the decoders that can receive this preset at this rate
+             * are tried. If there are none, the rate is not even sampled. */
+            uint32_t decoders = 0;
+            if (pass == 0) {
+                for (uint32_t j = 0; Decoders[j]; j++)
+                    if (decoder_accepts(Decoders[j], mod_class, rates[h]))
+                        decoders |= 1UL << j;
+                if (decoders == 0) {
+                    app->dbg_decoder_skip_count += numdecoders;
+                    continue;
+                }
+            } else {
+                decoders = fixable[h];
+                if (decoders == 0) continue;
+            }
+
+            TRACE(TraceDecodeTry, len, rates[h]);
+            if (ctx->dirty) {
+                memset(bitmap, 0, ctx->dirty);
+                ctx->dirty = 0;
+            }
+            decoded = decode_at_rate(bitmap, bitmap_size, s, len, rates[h],
+                                     profile, &decoders, order,
+                                     pass == 1 ? ctx->known : NULL,
+                                     &fixable[h], ctx->synced, target, evalp,
+                                     &bits,
+                                     &app->dbg_decoder_call_count);
+            if (pass == 0)
+                app->dbg_decoder_skip_count += numdecoders -
+                                               bitops_popcount32(decoders);
+            uint32_t used = (bits + 7) / 8;
+            ctx->dirty = used < bitmap_size ? used : bitmap_size;
+
+            if (LOG_ENABLED(LOG_LEVEL_DEBUG) && h == 0 && pass == 0 &&
+                ctx->debug_str)
+            {
+                char *str = ctx->debug_str;
+                uint32_t j;
+                for (j = 0; j < bits && j < DECODE_DEBUG_STR_LEN - 1; j++) {
+                    str[j] = bitmap_get(bitmap, bitmap_size, j) ? '1' : '0';
+                }
+                str[j] = 0;
+                LOG_D("%lu bits sampled: %s", bits, str);
+            }
+            if (decoded && evalp == NULL) break;
+        }
+    }
+
+    if (evalp) {
+        fieldset_free(trial.fieldset);
+        decoded = eval.found;
         if (decoded) {
-            info->decoder = Decoders[j];
-            break;
+            for (h = 0; h < numrates && rates[h] != eval.best_rate; h++);
+            if (eval.best_match >= 0) ctx->matches[eval.best_match].kept = true;
         }
-        j++;
     }
 
     if (decoded) {
-        FURI_LOG_E(TAG, "+++ Decoded %s", info->decoder->name);
-        if (info->pulses_count) {
-            info->bits_bytes = (info->pulses_count + 7) / 8;
-            info->bits = malloc(info->bits_bytes);
-            bitmap_copy(info->bits, info->bits_bytes, 0,
-                        bitmap, bitmap_size, info->start_off,
-                        info->pulses_count);
-        }
+        LOG_D("+++ Decoded %s (rate %lu us, measured %lu us)",
+            info->decoder->name, rates[h], measured);
+        app->dbg_rate_wins[hyps[h]]++;
+        s->short_pulse_dur = rates[h];
+        info->short_pulse_dur = rates[h];
+        if (evalp == NULL) msg_info_copy_bits(info, bitmap, bitmap_size);
+    } else {
+        TRACE(TraceDecodeFail, len, numrates);
     }
-    free(bitmap);
     return decoded;
 }
+
+/* =============================================================================
+ * Repeat combining
+ *
+ * A frame rejected because of a few bad bits is usually sent again a few
+ * milliseconds later, with its errors elsewhere. The failed copies are
+ * sampled again at the decoder's rate, aligned on its sync, and
+ * each bit of the frame takes the value most copies agree on: with three
+ * copies, any bit wrong in only one of them is corrected.
+ * ===========================================================================*/
+
+/* Return the rate to sample a run measured at 'measured' for decoder 'd'.
+ * Its nominal rate, if decode_signal() would try it: over a whole frame
+ * the measured one drifts by a few bits, and the copies must line up.
+ * Otherwise the measured rate or half of it, as the decoder accepts. */
+static uint32_t combine_rate(const ProtoViewDecoder *d, uint32_t mod_class,
+                             uint32_t measured)
+{
+    uint32_t rate = d->symbol_us;
+    if (rate && rate * 5 / 4 >= measured / 2 && rate <= measured * 5 / 4)
+        return rate;
+    if (decoder_accepts(d, mod_class, measured)) return measured;
+    return measured / 2;
+}
+
+/* Decode the majority vote of the 'numcopies' runs 'copies' of the buffer
+ * 's': runs that no decoder accepted, but where the sync of decoder 'j'
+ * was found, in the signal as received or 'inverted'. Each copy is sampled
+ * again and aligned on the first sync pattern found in the first copy;
+ * copies where it is missing don't vote. Only decoder 'j' is called, once.
+ * Returns true if it accepted the combined frame, filling 'info' like
+ * decode_signal() does. */
+bool decode_combined(ProtoViewApp *app, RawSamplesBuffer *s, ProtoViewScanCandidate **copies, uint32_t numcopies, uint32_t j, bool inverted, ProtoViewMsgInfo *info) {
+    ProtoViewDecodeCtx *ctx = &app->decode;
+    const ProtoViewDetectProfile *profile = &app->scan.profile;
+    ProtoViewDecoder *d = Decoders[j];
+    uint8_t *bitmap = ctx->bitmap;
+    uint8_t *votes = ctx->votes;
+    uint32_t span = d->max_bits + COMBINE_TAIL_BITS;
+    uint32_t first = SyncMatcher.first[j];
+    uint32_t sync = BITMAP_SEEK_NOT_FOUND;  /* Pattern index. */
+    uint32_t voters = 0, rate = 0;
+
+    /* With differential Manchester a wrong bit inverts all the levels
+     * after it, so the copies vote on the transitions instead. */
+    bool diff = d->line_code == LineCodeDiffManchester;
+
+    /* Count the ones of each bit of the frame, from its sync on. Bits past
+     * the end of a run count as zeros, as for the decoders. */
+    memset(votes, 0, span);
+    uint32_t saved_idx = s->idx;
+    for (uint32_t c = 0; c < numcopies; c++) {
+        const ProtoViewScanCandidate *copy = copies[c];
+        uint32_t bitmap_size = DECODE_ARENA_SIZE;
+        uint32_t copy_rate = combine_rate(d, app->scan.mod_class,
+                                          copy->short_pulse_dur);
+        s->short_pulse_dur = copy->short_pulse_dur;
+        s->level_bias = copy->level_bias;
+        s->idx = saved_idx;
+        raw_samples_center(s, copy->off);
+
+        if (ctx->dirty) memset(bitmap, 0, ctx->dirty);
+        uint32_t bits = convert_signal_to_bits(bitmap, bitmap_size, s,
+            -profile->before_samples,
+            copy->len + profile->before_samples + profile->after_samples,
+            copy_rate);
+        uint32_t used = (bits + 7) / 8;
+        ctx->dirty = used < bitmap_size ? used : bitmap_size;
+        if (inverted) bitmap_invert(bitmap, bitmap_size, bits);
+
+        SyncMatches m;
+        sync_matcher_run(bitmap, bitmap_size, bits, SyncMatcher.patterns[j],
+                         &m);
+        for (uint32_t k = 0; sync == BITMAP_SEEK_NOT_FOUND && d->sync[k]; k++)
+            if (m.exact[first + k] != BITMAP_SEEK_NOT_FOUND) sync = k;
+        if (sync == BITMAP_SEEK_NOT_FOUND ||
+            m.exact[first + sync] == BITMAP_SEEK_NOT_FOUND) continue;
+
+        BitReader r;
+        bit_reader_init(&r, bitmap, ctx->dirty, m.exact[first + sync]);
+        uint32_t prev = 0;
+        for (uint32_t b = 0; b < span; b++) {
+            uint32_t bit = bit_reader_get(&r, 1);
+            votes[b] += diff ? bit ^ prev : bit;
+            prev = bit;
+        }
+        if (voters++ == 0) rate = copy_rate;
+    }
+    s->idx = saved_idx;
+    if (voters < COMBINE_MIN_COPIES) return false;
+
+    /* Write the combined frame at the start of the bitmap, sync first. */
+    if (ctx->dirty) memset(bitmap, 0, ctx->dirty);
+    uint32_t size = (span + 7) / 8;
+    ctx->dirty = size;
+    BitWriter w;
+    bit_writer_init(&w, bitmap, size, 0);
+    uint32_t level = 0;
+    for (uint32_t b = 0; b < span; b++) {
+        uint32_t bit = votes[b] * 2 > voters;
+        level = diff ? level ^ bit : bit;
+        bit_writer_put(&w, level, 1);
+    }
+    bit_writer_flush(&w);
+
+    for (uint32_t k = 0; k < DECODER_MAX_SYNC; k++) {
+        info->sync_off[k] = BITMAP_SEEK_NOT_FOUND;
+        info->sync_errors[k] = 0;
+    }
+    info->sync_off[sync] = 0;
+
+    TRACE(TraceCombine, j, voters);
+    app->dbg_decoder_call_count++;
+    bool ok = d->decode ? d->decode(bitmap, size, span, info) :
+                          proto_desc_decode(d, bitmap, size, span, info);
+    if (!ok) return false;
+
+    LOG_D("+++ Decoded %s from %lu repeats", d->name, voters);
+    info->decoder = d;
+    info->inverted = inverted;
+    info->short_pulse_dur = rate;
+    msg_info_copy_bits(info, bitmap, size);
+    return true;
+}
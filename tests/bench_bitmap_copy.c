@@ -0,0 +1,122 @@
+/* Benchmark and check of bitmap_copy() on top of the bit cursors
+ * (bit_cursor.h), against the previous byte/bit implementation.
+ *
+ * Build and run on the host:
+ *
+ *   cc -O2 -o /tmp/bench_bitmap_copy tests/bench_bitmap_copy.c
+ *   /tmp/bench_bitmap_copy
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../bit_cursor.h"
+
+/* Previous implementation, from signal.c. */
+static void bitmap_set(uint8_t *b, uint32_t blen, uint32_t bitpos, bool val) {
+    uint32_t byte = bitpos / 8;
+    uint32_t bit = 7 - (bitpos & 7);
+    if (byte >= blen) return;
+    if (val)
+        b[byte] |= 1 << bit;
+    else
+        b[byte] &= ~(1 << bit);
+}
+
+static bool bitmap_get(uint8_t *b, uint32_t blen, uint32_t bitpos) {
+    uint32_t byte = bitpos / 8;
+    uint32_t bit = 7 - (bitpos & 7);
+    if (byte >= blen) return 0;
+    return (b[byte] & (1 << bit)) != 0;
+}
+
+static void old_bitmap_copy(uint8_t *d, uint32_t dlen, uint32_t doff,
+                            uint8_t *s, uint32_t slen, uint32_t soff,
+                            uint32_t count)
+{
+    if ((doff & 7) == 0 && (soff & 7) == 0) {
+        uint32_t didx = doff / 8;
+        uint32_t sidx = soff / 8;
+        while (count > 8 && didx < dlen && sidx < slen) {
+            d[didx++] = s[sidx++];
+            count -= 8;
+        }
+        doff = didx * 8;
+        soff = sidx * 8;
+    }
+
+    while (count > 8 && (doff & 7) != 0) {
+        bool bit = bitmap_get(s, slen, soff++);
+        bitmap_set(d, dlen, doff++, bit);
+        count--;
+    }
+
+    if (count > 8) {
+        uint8_t skew = soff % 8;
+        uint32_t didx = doff / 8;
+        uint32_t sidx = soff / 8;
+        while (count > 8 && didx < dlen && sidx < slen) {
+            d[didx] = ((s[sidx] << skew) | (s[sidx + 1] >> (8 - skew)));
+            sidx++;
+            didx++;
+            soff += 8;
+            doff += 8;
+            count -= 8;
+        }
+    }
+
+    while (count) {
+        bool bit = bitmap_get(s, slen, soff++);
+        bitmap_set(d, dlen, doff++, bit);
+        count--;
+    }
+}
+
+#define SLEN 64
+#define DLEN 64
+
+int main(void) {
+    /* The old code may read one byte past 'slen' for unaligned copies:
+     * keep a zeroed guard byte there so that both versions agree. */
+    static uint8_t src[SLEN + 1];
+    static uint8_t d1[DLEN], d2[DLEN];
+    srand(1234);
+
+    /* Check: same output for random offsets and lengths. */
+    long mismatches = 0;
+    for (int j = 0; j < 200000; j++) {
+        for (int k = 0; k < SLEN; k++) src[k] = rand();
+        for (int k = 0; k < DLEN; k++) d1[k] = d2[k] = rand();
+        uint32_t soff = rand() % (SLEN * 8);
+        uint32_t doff = rand() % (DLEN * 8);
+        uint32_t count = rand() % (SLEN * 8 - soff + 1);
+        old_bitmap_copy(d1, DLEN, doff, src, SLEN, soff, count);
+        bit_cursor_copy(d2, DLEN, doff, src, SLEN, soff, count);
+        if (memcmp(d1, d2, DLEN)) mismatches++;
+    }
+    printf("check: %ld mismatches\n", mismatches);
+
+    /* Benchmark: the typical decoder case, 64 bits at unaligned offsets
+     * (see the PMV-107J realignment), and a longer copy like the one done
+     * by decode_signal() to save the message bits. */
+    struct { uint32_t count; const char *desc; } cases[] = {
+        {64, "64 bits"},
+        {400, "400 bits"},
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint32_t count = cases[c].count;
+        long iter = 2000000;
+        clock_t start = clock();
+        for (long j = 0; j < iter; j++)
+            old_bitmap_copy(d1, DLEN, j & 7, src, SLEN, 2 + (j & 3), count);
+        double t_old = (double)(clock() - start) / CLOCKS_PER_SEC;
+        start = clock();
+        for (long j = 0; j < iter; j++)
+            bit_cursor_copy(d2, DLEN, j & 7, src, SLEN, 2 + (j & 3), count);
+        double t_new = (double)(clock() - start) / CLOCKS_PER_SEC;
+        printf("%-8s unaligned: old %.3fs new %.3fs (%.1fx)\n",
+               cases[c].desc, t_old, t_new, t_old / t_new);
+    }
+    return mismatches != 0;
+}
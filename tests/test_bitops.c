@@ -0,0 +1,111 @@
+/* Check the bit kernels of bitops.h against straightforward reference
+ * implementations, and the selected kernels against the portable ones.
+ * On the host the selected kernels are the portable ones; build this file
+ * for the Cortex-M4 to check the instruction based versions too.
+ *
+ * Build and run on the host:
+ *
+ *   cc -O2 -o /tmp/test_bitops tests/test_bitops.c
+ *   /tmp/test_bitops
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../bitops.h"
+
+static uint32_t ref_rbit32(uint32_t x) {
+    uint32_t r = 0;
+    for (int j = 0; j < 32; j++) if (x & (1UL << j)) r |= 1UL << (31 - j);
+    return r;
+}
+
+static uint32_t ref_clz32(uint32_t x) {
+    uint32_t n = 0;
+    for (int j = 31; j >= 0 && !(x & (1UL << j)); j--) n++;
+    return n;
+}
+
+static uint32_t ref_ctz32(uint32_t x) {
+    uint32_t n = 0;
+    for (int j = 0; j < 32 && !(x & (1UL << j)); j++) n++;
+    return n;
+}
+
+static uint32_t ref_popcount32(uint32_t x) {
+    uint32_t n = 0;
+    for (int j = 0; j < 32; j++) n += (x >> j) & 1;
+    return n;
+}
+
+/* The CRC loops that crc.c used before moving to the kernels. */
+static uint8_t ref_crc8_byte(uint8_t crc, uint8_t byte, uint8_t poly) {
+    crc ^= byte;
+    for (int j = 0; j < 8; j++)
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ poly) : (uint8_t)(crc << 1);
+    return crc;
+}
+
+static uint16_t ref_crc16_byte(uint16_t crc, uint8_t byte, uint16_t poly) {
+    crc ^= (uint16_t)byte << 8;
+    for (int j = 0; j < 8; j++)
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ poly) : (uint16_t)(crc << 1);
+    return crc;
+}
+
+static int failures = 0;
+
+#define CHECK(cond, what, x) do { \
+    if (!(cond)) { \
+        if (failures < 10) printf("FAIL %s(0x%08lx)\n", what, (unsigned long)(x)); \
+        failures++; \
+    } \
+} while(0)
+
+static uint32_t rand32(void) {
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+int main(void) {
+    srand(1234);
+    for (long j = 0; j < 1000000; j++) {
+        /* Mix random words with sparse ones, to exercise clz/ctz. */
+        uint32_t x = rand32();
+        if (j & 1) x >>= rand() % 33 == 32 ? 31 : rand() % 32;
+        if (j % 1000 == 0) x = 0;
+
+        CHECK(bitops_rbit32(x) == ref_rbit32(x), "rbit32", x);
+        CHECK(bitops_rbit32(x) == bitops_rbit32_portable(x), "rbit32 portable", x);
+        CHECK(bitops_rev32(x) == __builtin_bswap32(x), "rev32", x);
+        CHECK(bitops_rev32(x) == bitops_rev32_portable(x), "rev32 portable", x);
+        CHECK(bitops_clz32(x) == ref_clz32(x), "clz32", x);
+        CHECK(bitops_clz32(x) == bitops_clz32_portable(x), "clz32 portable", x);
+        CHECK(bitops_ctz32(x) == ref_ctz32(x), "ctz32", x);
+        CHECK(bitops_popcount32(x) == ref_popcount32(x), "popcount32", x);
+
+        uint64_t y = ((uint64_t)rand32() << 32) | x;
+        CHECK(bitops_popcount64(y) == ref_popcount32(y >> 32) + ref_popcount32(x),
+              "popcount64", x);
+
+        uint32_t r8 = 0;
+        for (int b = 0; b < 4; b++)
+            r8 |= (ref_rbit32((x >> (b * 8)) & 0xff) >> 24) << (b * 8);
+        CHECK(bitops_rbit8x4(x) == r8, "rbit8x4", x);
+
+        uint8_t buf[5] = {0};
+        bitops_store_be32(buf + (j & 1), x);
+        CHECK(buf[j & 1] == x >> 24 && buf[(j & 1) + 3] == (x & 0xff),
+              "store_be32", x);
+        CHECK(bitops_load_be32(buf + (j & 1)) == x, "load_be32", x);
+
+        uint8_t byte = x >> 24, poly8 = x >> 16, crc8 = x >> 8;
+        uint16_t poly16 = x, crc16 = x >> 16;
+        CHECK(bitops_crc8_byte(crc8, byte, poly8) ==
+              ref_crc8_byte(crc8, byte, poly8), "crc8_byte", x);
+        CHECK(bitops_crc16_byte(crc16, byte, poly16) ==
+              ref_crc16_byte(crc16, byte, poly16), "crc16_byte", x);
+    }
+
+    printf("%s: %d failures\n", BITOPS_CORTEX_M4 ? "cortex-m4" : "portable",
+           failures);
+    return failures != 0;
+}
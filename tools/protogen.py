@@ -0,0 +1,654 @@
+#!/usr/bin/env python3
+"""
+TPMS decoder generator.
+
+Turns the protocol specs in protocols/specs/*.spec into C decoders in
+protocols/generated/, and writes protocols/generated/decoders.h, which
+declares them and registers them in Decoders[] of signal.c. The position
+in Decoders[] is the priority of a decoder: the "slot" of a spec places
+its decoder after that many hand-written decoders there. The header
+defines GENERATED_DECODERS_AT_<slot> for every slot, listing the
+generated decoders of the slot in spec file name order, and Decoders[]
+expands each one at its place, so a new spec needs no signal.c edit.
+
+By default every spec becomes a specialised decoder: the payload length,
+the sync length, the checksum range and the field positions are constants
+of the generated code, CRCs use 256 entry tables computed here, and each
+field is read with a fixed expression of the payload bytes. A CRC8 stored
+right after the bytes it covers lets the decoder correct a single bit
+error, see decoder_fix_crc8() and TPMS_CRC_FIX. A spec with
+"engine table" is emitted as a ProtoViewProtoDesc interpreted at runtime
+by proto_engine.c instead: slower, but smaller, for rarely seen protocols.
+
+Spec format: one "key value..." per line, '#' lines before the first key
+are the protocol description copied in the generated file.
+
+    decoder         C name of the ProtoViewDecoder
+    slot            hand-written decoders before it (default: all of them)
+    name            "Name shown in the UI"
+    engine          code | table                  (default code)
+    sync            sync pattern, as in ProtoViewDecoder.sync
+    skip            bits from sync start to payload (default: sync length)
+    sync_max_errors N                             (default 0)
+    allow_inverted  yes | no                      (default no)
+    modulation      ook | fsk | any
+    line_code       manchester | manchester-10-is-0 | diff-manchester
+    symbol_us       nominal min max
+    bits            min max                       (frame length, raw bits)
+    bytes           payload bytes after the sync
+    set             byte mask                     (OR'ed before the check)
+    check           crc8|crc16|sum8|xor8 first-last at|zero [poly=] [init=]
+    field           "Name" type bitpos width [scale=] [offset=] [digits=]
+
+Field types: bytes, float, int, uint, hex, bin. Bit positions count from
+the MSB of the first payload byte. A bytes field must end on a byte
+boundary; the bits before its start in the first byte are masked off.
+
+Usage:
+    python3 tools/protogen.py [--check] [specs_dir] [out_dir]
+
+With --check nothing is written, and the exit code is 1 if the files in
+out_dir are not the ones the specs generate. Files of out_dir that no
+spec generates are removed, but only the ones this tool wrote.
+"""
+
+import glob
+import os
+import shlex
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HEADER = "decoders.h"
+CRC_TABLES = "crc_tables.c"
+# Start of every generated file: only files starting so are ever removed.
+ORIGIN = "/* Generated by tools/protogen.py from "
+# Hand-written decoders in Decoders[] of signal.c, plus one: a generated
+# decoder can go before, between or after them.
+SLOTS = 10
+
+MODULATIONS = {"ook": "MOD_CLASS_OOK", "fsk": "MOD_CLASS_FSK",
+               "any": "MOD_CLASS_ANY"}
+LINE_CODES = {"manchester": "LineCodeManchester",
+              "manchester-10-is-0": "LineCodeManchester",
+              "diff-manchester": "LineCodeDiffManchester"}
+CHECKS = {"crc8": "ProtoCheckCrc8", "crc16": "ProtoCheckCrc16",
+          "sum8": "ProtoCheckSum8", "xor8": "ProtoCheckXor8"}
+# ProtoViewDecoder.check_bits of each check.
+CHECK_BITS = {"crc8": 8, "crc16": 16, "sum8": 6, "xor8": 6}
+FIELD_TYPES = {"bytes": "FieldTypeBytes", "float": "FieldTypeFloat",
+               "int": "FieldTypeSignedInt", "uint": "FieldTypeUnsignedInt",
+               "hex": "FieldTypeHex", "bin": "FieldTypeBinary"}
+
+
+class SpecError(Exception):
+    pass
+
+
+# ─── Spec parsing ────────────────────────────────────────────────────────────
+
+def parse_number(s):
+    return int(s, 0)
+
+
+def parse_options(words, allowed, where):
+    opts = {}
+    for w in words:
+        if "=" not in w:
+            raise SpecError(f"{where}: unexpected '{w}'")
+        k, v = w.split("=", 1)
+        if k not in allowed:
+            raise SpecError(f"{where}: unknown option '{k}'")
+        opts[k] = v
+    return opts
+
+
+def parse_spec(path):
+    spec = {"path": path, "comment": [], "fields": [], "set": [],
+            "engine": "code", "sync_max_errors": 0, "allow_inverted": False,
+            "slot": SLOTS - 1}
+    in_comment = True
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            where = f"{os.path.basename(path)}:{lineno}"
+            line = line.rstrip("\n")
+            if line.startswith("#"):
+                if in_comment:
+                    text = line[1:]
+                    spec["comment"].append(text[1:] if text.startswith(" ")
+                                           else text)
+                continue
+            words = shlex.split(line)
+            if not words:
+                continue
+            in_comment = False
+            key, args = words[0], words[1:]
+            try:
+                parse_line(spec, key, args, where)
+            except (ValueError, IndexError):
+                raise SpecError(f"{where}: bad '{key}' line")
+    for key in ("decoder", "name", "sync", "modulation", "line_code",
+                "symbol_us", "bits", "bytes", "check"):
+        if key not in spec:
+            raise SpecError(f"{path}: missing '{key}'")
+    spec.setdefault("skip", len(spec["sync"]))
+    validate_spec(spec)
+    return spec
+
+
+def parse_line(spec, key, args, where):
+    if key in ("decoder", "name", "sync"):
+        spec[key] = args[0]
+    elif key == "engine":
+        if args[0] not in ("code", "table"):
+            raise SpecError(f"{where}: engine is 'code' or 'table'")
+        spec[key] = args[0]
+    elif key in ("skip", "sync_max_errors", "bytes"):
+        spec[key] = parse_number(args[0])
+    elif key == "slot":
+        spec[key] = parse_number(args[0])
+        if not 0 <= spec[key] < SLOTS:
+            raise SpecError(f"{where}: slot is 0 to {SLOTS - 1}")
+    elif key == "allow_inverted":
+        spec[key] = args[0] == "yes"
+    elif key == "modulation":
+        if args[0] not in MODULATIONS:
+            raise SpecError(f"{where}: unknown modulation '{args[0]}'")
+        spec[key] = args[0]
+    elif key == "line_code":
+        if args[0] not in LINE_CODES:
+            raise SpecError(f"{where}: unknown line code '{args[0]}'")
+        spec[key] = args[0]
+    elif key == "symbol_us":
+        spec[key] = [parse_number(a) for a in args[:3]]
+    elif key == "bits":
+        spec[key] = [parse_number(a) for a in args[:2]]
+    elif key == "set":
+        spec["set"].append((parse_number(args[0]), parse_number(args[1])))
+    elif key == "check":
+        if args[0] not in CHECKS:
+            raise SpecError(f"{where}: unknown check '{args[0]}'")
+        first, last = (parse_number(a) for a in args[1].split("-"))
+        opts = parse_options(args[3:], ("poly", "init"), where)
+        spec[key] = {"kind": args[0], "from": first, "len": last - first + 1,
+                     "at": -1 if args[2] == "zero" else parse_number(args[2]),
+                     "poly": parse_number(opts.get("poly", "0")),
+                     "init": parse_number(opts.get("init", "0"))}
+    elif key == "field":
+        if args[1] not in FIELD_TYPES:
+            raise SpecError(f"{where}: unknown field type '{args[1]}'")
+        opts = parse_options(args[4:], ("scale", "offset", "digits"), where)
+        spec["fields"].append({"name": args[0], "type": args[1],
+                               "bitpos": parse_number(args[2]),
+                               "width": parse_number(args[3]),
+                               "scale": float(opts.get("scale", "1")),
+                               "offset": float(opts.get("offset", "0")),
+                               "digits": int(opts.get("digits", "0"))})
+    else:
+        raise SpecError(f"{where}: unknown key '{key}'")
+
+
+def validate_spec(spec):
+    path = spec["path"]
+    nbytes = spec["bytes"]
+    if not 0 < nbytes <= 32:
+        raise SpecError(f"{path}: payload is 1 to 32 bytes")
+    c = spec["check"]
+    end = c["at"] + (2 if c["kind"] == "crc16" else 1)
+    if c["from"] + c["len"] > nbytes or end > nbytes:
+        raise SpecError(f"{path}: check outside the payload")
+    for f in spec["fields"]:
+        if f["bitpos"] + f["width"] > nbytes * 8:
+            raise SpecError(f"{path}: field '{f['name']}' outside the payload")
+        if f["type"] == "bytes":
+            if (f["bitpos"] + f["width"]) % 8:
+                raise SpecError(f"{path}: bytes field '{f['name']}' must end "
+                                "on a byte boundary")
+        elif f["width"] > 32:
+            raise SpecError(f"{path}: field '{f['name']}' wider than 32 bits")
+    if spec["engine"] == "table":
+        # What proto_engine.c supports.
+        if spec["set"]:
+            raise SpecError(f"{path}: 'set' needs engine code")
+        if spec["skip"] != len(spec["sync"]):
+            raise SpecError(f"{path}: 'skip' needs engine code")
+        for f in spec["fields"]:
+            if f["type"] == "bytes" and (f["bitpos"] % 8 or f["width"] % 8):
+                raise SpecError(f"{path}: unaligned bytes field '{f['name']}'"
+                                " needs engine code")
+
+
+# ─── C emission helpers ──────────────────────────────────────────────────────
+
+def c_string(s):
+    return '"' + s.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def c_float(v):
+    s = repr(float(v))
+    return s + "f"
+
+
+def crc8_table(poly):
+    table = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = ((c << 1) ^ poly if c & 0x80 else c << 1) & 0xFF
+        table.append(c)
+    return table
+
+
+def crc16_table(poly):
+    table = []
+    for i in range(256):
+        c = i << 8
+        for _ in range(8):
+            c = ((c << 1) ^ poly if c & 0x8000 else c << 1) & 0xFFFF
+        table.append(c)
+    return table
+
+
+def crc_table_name(check):
+    if check["kind"] == "crc8":
+        return "CrcTable8Poly%02X" % check["poly"]
+    return "CrcTable16Poly%04X" % check["poly"]
+
+
+def bits_expr(bitpos, width):
+    """C expression reading 'width' bits at 'bitpos' of raw[], MSB first."""
+    first, last = bitpos // 8, (bitpos + width - 1) // 8
+    shift = 8 * (last + 1) - (bitpos + width)
+    terms = []
+    for i in range(first, last + 1):
+        left = 8 * (last - i) - shift
+        if left > 0:
+            terms.append(f"(uint32_t)raw[{i}] << {left}")
+        elif left < 0:
+            terms.append(f"raw[{i}] >> {-left}")
+        else:
+            terms.append(f"raw[{i}]")
+    expr = " | ".join(terms)
+    if width < 8 * (last - first + 1) - shift:
+        mask = (1 << width) - 1
+        expr = f"{paren(expr)} & 0x{mask:x}"
+    return expr
+
+
+def paren(expr):
+    """Parenthesize 'expr' unless it is a single payload byte."""
+    return expr if expr.startswith("raw[") and expr.endswith("]") and \
+        " " not in expr else f"({expr})"
+
+
+def wrap(line, sep):
+    """Break a C statement longer than 78 columns after 'sep'."""
+    out = []
+    while len(line) > 78:
+        cut = line.rfind(sep, 0, 78 - len(sep.rstrip()))
+        if cut < 0:
+            break
+        out.append(line[:cut + len(sep.rstrip())])
+        line = "        " + line[cut + len(sep):]
+    return "\n".join(out + [line])
+
+
+def call(func, args):
+    """A call statement, breaking after the field name if too long."""
+    line = f"    {func}({', '.join(args)});"
+    if len(line) <= 79:
+        return line
+    return (f"    {func}({', '.join(args[:2])},\n"
+            f"        {', '.join(args[2:])});")
+
+
+def comment_block(lines, extra):
+    out = ["/* " + extra[0]]
+    out += [(" * " + l).rstrip() for l in extra[1:]]
+    if lines:
+        out.append(" *")
+        out += [(" * " + l).rstrip() for l in lines]
+    out[-1] += " */"
+    return "\n".join(out)
+
+
+def crc_fixable(check):
+    """True if single bit errors can be corrected: a CRC8 right after the
+    bytes it covers, as crc8_fix_single_bit() expects."""
+    return (check["kind"] == "crc8" and
+            check["at"] == check["from"] + check["len"])
+
+
+def spec_relpath(spec):
+    return os.path.relpath(spec["path"], ROOT).replace(os.sep, "/")
+
+
+def emit_decoder_struct(spec, decode, desc):
+    s = spec
+    lines = [f"ProtoViewDecoder {s['decoder']} = {{",
+             f"    .name = {c_string(s['name'])},",
+             f"    .decode = {decode},",
+             "    .get_fields = NULL,",
+             "    .build_message = NULL,",
+             "    .sync = sync_patterns,"]
+    if s["allow_inverted"]:
+        lines.append("    .allow_inverted = true,")
+    if s["sync_max_errors"]:
+        lines.append(f"    .sync_max_errors = {s['sync_max_errors']},")
+    lines += [f"    .mod_class = {MODULATIONS[s['modulation']]},",
+              f"    .line_code = {LINE_CODES[s['line_code']]},",
+              f"    .symbol_us = {s['symbol_us'][0]},",
+              f"    .symbol_min_us = {s['symbol_us'][1]},",
+              f"    .symbol_max_us = {s['symbol_us'][2]},",
+              f"    .min_bits = {s['bits'][0]},",
+              f"    .max_bits = {s['bits'][1]},",
+              f"    .check_bits = {CHECK_BITS[s['check']['kind']]}"]
+    if crc_fixable(s["check"]):
+        lines[-1] += ","
+        lines.append("    .crc_fix = true")
+    if desc:
+        lines[-1] += ","
+        lines.append("    .desc = &desc")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+# ─── Specialised decoder ─────────────────────────────────────────────────────
+
+def emit_line_decode(spec):
+    nbytes = spec["bytes"]
+    lc = spec["line_code"]
+    if lc == "diff-manchester":
+        call = (f"diff_manchester_decode(\n        raw, sizeof(raw), "
+                f"bits, numbytes, off, {nbytes * 8})")
+    else:
+        patterns = ('"10", "01"' if lc == "manchester-10-is-0"
+                    else '"01", "10"')
+        call = (f"convert_from_line_code(\n        raw, sizeof(raw), "
+                f"bits, numbytes, off, {patterns})")
+    return [f"    uint8_t raw[{nbytes}];",
+            f"    uint32_t decoded = {call};",
+            f"    if (decoded < {nbytes * 8}) return false;"]
+
+
+def emit_check(spec):
+    c = spec["check"]
+    first, last = c["from"], c["from"] + c["len"] - 1
+    out = []
+    if c["kind"] in ("crc8", "crc16"):
+        table = crc_table_name(c)
+        if c["kind"] == "crc8":
+            out.append(f"    uint8_t check = 0x{c['init']:02x};")
+            step = f"check = {table}[check ^ raw[j]];"
+        else:
+            out.append(f"    uint16_t check = 0x{c['init']:04x};")
+            step = f"check = (check << 8) ^ {table}[(check >> 8) ^ raw[j]];"
+        out += [f"    for (int j = {first}; j <= {last}; j++)",
+                f"        {step}"]
+        value = "check"
+    else:
+        op = " ^ " if c["kind"] == "xor8" else " + "
+        terms = [f"raw[{i}]" for i in range(first, last + 1)]
+        if c["init"]:
+            terms.insert(0, f"0x{c['init']:02x}")
+        out.append(wrap(f"    uint8_t check = {op.join(terms)};", op))
+        value = "check"
+    if c["at"] < 0:
+        expected = "0"
+    elif c["kind"] == "crc16":
+        expected = f"(raw[{c['at']}] << 8 | raw[{c['at'] + 1}])"
+    else:
+        expected = f"raw[{c['at']}]"
+    if not crc_fixable(c):
+        out.append(f"    if ({value} != {expected}) return false;")
+        return out
+    data = f"raw + {first}" if first else "raw"
+    fix = f"decoder_fix_crc8(info, {data}, {c['len']}, " \
+          f"0x{c['init']:02x}, 0x{c['poly']:02x})"
+    out.append(f"    if ({value} != {expected} &&")
+    if not spec["set"]:
+        out.append(f"        !{fix}) return false;")
+        return out
+    # A correction of a bit forced by 'set' means the error was elsewhere.
+    out.append(f"        !({fix} &&")
+    conds = [f"(raw[{byte}] & 0x{mask:02x}) == 0x{mask:02x}"
+             for byte, mask in spec["set"]]
+    out.append(f"          {' && '.join(conds)})) return false;")
+    return out
+
+
+def emit_field(f, n):
+    name = c_string(f["name"])
+    p, w = f["bitpos"], f["width"]
+    t = f["type"]
+    if t == "bytes":
+        first, nbytes = p // 8, (w + 7) // 8
+        if p % 8 == 0:
+            data = f"raw + {first}" if first else "raw"
+            return [call("fieldset_add_bytes",
+                         ["info->fieldset", name, data, str(nbytes * 2)])]
+        # Right align the field in its own bytes, masking the bits of the
+        # first byte that come before it.
+        items = [f"raw[{first}] & 0x{(1 << (8 - p % 8)) - 1:02x}"]
+        items += [f"raw[{i}]" for i in range(first + 1, first + nbytes)]
+        return [f"    const uint8_t field{n}[{nbytes}] = "
+                f"{{{', '.join(items)}}};",
+                call("fieldset_add_bytes",
+                     ["info->fieldset", name, f"field{n}", str(nbytes * 2)])]
+    expr = bits_expr(p, w)
+    if t == "float":
+        value = f"(float){paren(expr)}"
+        if f["scale"] != 1:
+            value += f" * {c_float(f['scale'])}"
+        if f["offset"]:
+            sign = "-" if f["offset"] < 0 else "+"
+            value += f" {sign} {c_float(abs(f['offset']))}"
+        return [call("fieldset_add_float",
+                     ["info->fieldset", name, value, str(f["digits"])])]
+    if t == "int":
+        value = f"(int){paren(expr)}"
+        off = int(f["offset"])
+        if off:
+            value += f" {'-' if off < 0 else '+'} {abs(off)}"
+        return [call("fieldset_add_int",
+                     ["info->fieldset", name, value, str(w)])]
+    func = {"uint": "fieldset_add_uint", "hex": "fieldset_add_hex",
+            "bin": "fieldset_add_bin"}[t]
+    return [call(func, ["info->fieldset", name, expr, str(w)])]
+
+
+def emit_code(spec):
+    s = spec
+    nbytes = s["bytes"]
+    out = ["static bool decode(uint8_t *bits, uint32_t numbytes, "
+           "uint32_t numbits,",
+           "                   ProtoViewMsgInfo *info)",
+           "{",
+           f"    if (numbits < {s['bits'][0]}) return false;",
+           "",
+           "    uint32_t off = info->sync_off[0];",
+           "    if (off == BITMAP_SEEK_NOT_FOUND) return false;",
+           "    info->start_off = off;",
+           f"    off += {s['skip']};",
+           ""]
+    out += emit_line_decode(s)
+    out.append("")
+    for byte, mask in s["set"]:
+        out.append(f"    raw[{byte}] |= 0x{mask:02x};")
+    out += emit_check(s)
+    out += ["",
+            f"    info->pulses_count = (off + {nbytes * 8 * 2}) - "
+            "info->start_off;"]
+    for n, f in enumerate(s["fields"]):
+        out += emit_field(f, n)
+    out += ["    return true;", "}"]
+    return "\n".join(out)
+
+
+# ─── Table driven decoder ────────────────────────────────────────────────────
+
+def emit_table(spec):
+    s = spec
+    c = s["check"]
+    out = ["static const ProtoViewFieldDesc fields[] = {"]
+    for f in s["fields"]:
+        out.append(f"    {{{c_string(f['name'])}, {FIELD_TYPES[f['type']]}, "
+                   f"{f['bitpos']}, {f['width']}, {f['digits']}, "
+                   f"{c_float(f['scale'])}, {c_float(f['offset'])}}},")
+    out += ["    {NULL, 0, 0, 0, 0, 0, 0}", "};", "",
+            "static const ProtoViewProtoDesc desc = {",
+            f"    .len = {s['bytes']},"]
+    if s["line_code"] == "manchester-10-is-0":
+        out.append("    .flags = PROTO_DESC_MANCHESTER_10_IS_0,")
+    out += [f"    .check = {{{CHECKS[c['kind']]}, {c['from']}, {c['len']}, "
+            f"{c['at']}, 0x{c['poly']:02x}, 0x{c['init']:02x}}},",
+            "    .fields = fields,",
+            "};"]
+    return "\n".join(out)
+
+
+# ─── Files ───────────────────────────────────────────────────────────────────
+
+def generate_decoder(spec):
+    origin = [f"Generated by tools/protogen.py from {spec_relpath(spec)}.",
+              "Do not edit: change the spec and run the generator."]
+    parts = [comment_block(spec["comment"], origin),
+             '#include "../../app.h"\n#include "decoders.h"',
+             "static const char *sync_patterns[] = "
+             f"{{{c_string(spec['sync'])}, NULL}};"]
+    if spec["engine"] == "table":
+        parts += [emit_table(spec), emit_decoder_struct(spec, "NULL", True)]
+    else:
+        parts += [emit_code(spec), emit_decoder_struct(spec, "decode", False)]
+    return "\n\n".join(parts) + "\n"
+
+
+def generate_header(specs, tables):
+    out = ["/* Generated by tools/protogen.py from the protocols/specs files.",
+           " * Do not edit: change the specs and run the generator.",
+           " *",
+           " * Declarations of the generated decoders and of the CRC tables",
+           " * they share, and their entries of the Decoders[] table of",
+           " * signal.c: GENERATED_DECODERS_AT_<n> lists the ones placed after",
+           " * the first n hand-written decoders there. */",
+           "",
+           "#pragma once",
+           ""]
+    out += [f"extern ProtoViewDecoder {s['decoder']};" for s in specs]
+    out.append("")
+    for name, width in tables:
+        out.append(f"extern const uint{width}_t {name}[256];")
+    out.append("")
+    for slot in range(SLOTS):
+        entries = "".join(f" &{s['decoder']}," for s in specs
+                          if s["slot"] == slot)
+        out.append(f"#define GENERATED_DECODERS_AT_{slot}{entries}")
+    return "\n".join(out) + "\n"
+
+
+def generate_crc_tables(tables):
+    out = ["/* Generated by tools/protogen.py from the protocols/specs files.",
+           " * Do not edit: change the specs and run the generator.",
+           " *",
+           " * CRC tables of the generated decoders, MSB first: one step of",
+           " * CRC8 is crc = table[crc ^ byte], one step of CRC16 is",
+           " * crc = (crc << 8) ^ table[(crc >> 8) ^ byte]. */",
+           "",
+           "#include <stdint.h>"]
+    for name, width in tables:
+        poly = int(name.split("Poly")[1], 16)
+        values = crc8_table(poly) if width == 8 else crc16_table(poly)
+        fmt = "0x%02x" if width == 8 else "0x%04x"
+        per_line = 12 if width == 8 else 8
+        out += ["", f"const uint{width}_t {name}[256] = {{"]
+        for i in range(0, 256, per_line):
+            row = ", ".join(fmt % v for v in values[i:i + per_line])
+            out.append(f"    {row},")
+        out[-1] = out[-1][:-1]
+        out.append("};")
+    return "\n".join(out) + "\n"
+
+
+def generate(specs_dir):
+    specs = [parse_spec(p) for p in sorted(glob.glob(
+        os.path.join(specs_dir, "*.spec")))]
+    names = [s["decoder"] for s in specs]
+    if len(set(names)) != len(names):
+        raise SpecError("duplicated decoder names")
+    tables = sorted({(crc_table_name(s["check"]),
+                      8 if s["check"]["kind"] == "crc8" else 16)
+                     for s in specs if s["engine"] == "code" and
+                     s["check"]["kind"] in ("crc8", "crc16")})
+    files = {HEADER: generate_header(specs, tables),
+             CRC_TABLES: generate_crc_tables(tables)}
+    for s in specs:
+        base = os.path.splitext(os.path.basename(s["path"]))[0]
+        files[base + ".c"] = generate_decoder(s)
+    return files
+
+
+USAGE = "usage: protogen.py [--check] [specs_dir] [out_dir]"
+
+
+def generated_here(path):
+    """True if 'path' was written by this tool."""
+    try:
+        with open(path, encoding="utf-8") as f:
+            return f.read(len(ORIGIN)) == ORIGIN
+    except (OSError, UnicodeDecodeError):
+        return False
+
+
+def main(argv):
+    check = "--check" in argv
+    args = [a for a in argv if a != "--check"]
+    if len(args) > 2 or any(a.startswith("-") for a in args):
+        print(USAGE, file=sys.stderr)
+        return 2
+    specs_dir = args[0] if args else os.path.join(ROOT, "protocols", "specs")
+    out_dir = args[1] if len(args) > 1 else \
+        os.path.join(ROOT, "protocols", "generated")
+    # With no specs every generated decoder would be removed as stale.
+    if not os.path.isdir(specs_dir):
+        print(f"protogen: {specs_dir}: not a directory", file=sys.stderr)
+        return 1
+    if not glob.glob(os.path.join(specs_dir, "*.spec")):
+        print(f"protogen: no .spec files in {specs_dir}", file=sys.stderr)
+        return 1
+    try:
+        files = generate(specs_dir)
+    except SpecError as e:
+        print(f"protogen: {e}", file=sys.stderr)
+        return 1
+
+    existing = set(os.path.basename(p) for p in
+                   glob.glob(os.path.join(out_dir, "*.[ch]"))
+                   if generated_here(p))
+    stale = sorted(existing - set(files))
+    changed = []
+    for name, content in sorted(files.items()):
+        path = os.path.join(out_dir, name)
+        try:
+            with open(path, encoding="utf-8") as f:
+                if f.read() == content:
+                    continue
+        except FileNotFoundError:
+            pass
+        changed.append(name)
+        if not check:
+            os.makedirs(out_dir, exist_ok=True)
+            with open(path, "w", encoding="utf-8") as f:
+                f.write(content)
+
+    if check:
+        for name in changed + stale:
+            print(f"protogen: {name} is out of date", file=sys.stderr)
+        return 1 if changed or stale else 0
+    # Only rewrite what changed, so that the build does not recompile the
+    # generated decoders every time.
+    for name in stale:
+        os.remove(os.path.join(out_dir, name))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -19,15 +19,6 @@ void tpms_sensor_list_clear(TPMSSensorList *list) {
     memset(list->sensors, 0, sizeof(list->sensors));
 }
 
-/* Find a field in a fieldset by name. Returns NULL if not found. */
-static ProtoViewField *fieldset_find(ProtoViewFieldSet *fs, const char *name) {
-    for (uint32_t i = 0; i < fs->numfields; i++) {
-        if (strcmp(fs->fields[i]->name, name) == 0)
-            return fs->fields[i];
-    }
-    return NULL;
-}
-
 /* Find a sensor in the list by its ID. Returns index or -1. */
 static int sensor_list_find(TPMSSensorList *list, uint8_t *id, uint8_t id_len) {
     for (uint32_t i = 0; i < list->count; i++) {
@@ -40,6 +31,24 @@ static int sensor_list_find(TPMSSensorList *list, uint8_t *id, uint8_t id_len) {
     return -1;
 }
 
+/* Return true if the message with fieldset 'fs', decoded by the decoder
+ * named 'protocol', comes from a sensor of the list: same tire ID, and
+ * last decoded by the same decoder. */
+bool tpms_sensor_known(TPMSSensorList *list, const char *protocol,
+                       ProtoViewFieldSet *fs)
+{
+    ProtoViewField *id_field = fieldset_find(fs, "Tire ID");
+    if (!id_field || id_field->type != FieldTypeBytes) return false;
+    uint8_t id_bytes = (id_field->len + 1) / 2;
+    if (id_bytes > TPMS_ID_MAX_BYTES) id_bytes = TPMS_ID_MAX_BYTES;
+
+    int idx = sensor_list_find(list, id_field->bytes, id_bytes);
+    if (idx < 0) return false;
+    const char *name = list->sensors[idx].protocol;
+    return strncmp(name, protocol, sizeof(list->sensors[idx].protocol) - 1)
+           == 0;
+}
+
 /* Append a sensor reading to the log file on the SD card.
  * Format: ID_hex,protocol,pressure_psi,temperature_f,rx_count */
 void tpms_save_to_file(ProtoViewApp *app, TPMSSensor *sensor) {
@@ -96,13 +105,14 @@ void tpms_save_to_file(ProtoViewApp *app, TPMSSensor *sensor) {
     storage_file_free(file);
 }
 
-/* Write a debug event to the SD card log.
- * Format: ts_ms,event,modulation,scans,coherent,tries,decoded,detail */
-void tpms_debug_log(ProtoViewApp *app, const char *event, const char *detail) {
-    if (!app->debug_logging || !app->storage) return;
+/* Open the SD card debug log for appending, writing the CSV header if
+ * the file is new. Returns NULL if debug logging is off or the file
+ * can't be opened. Close it with tpms_debug_log_close(). */
+File *tpms_debug_log_open(ProtoViewApp *app) {
+    if (!app->debug_logging || !app->storage) return NULL;
 
     File *file = storage_file_alloc(app->storage);
-    if (!file) return;
+    if (!file) return NULL;
 
     FuriString *dir_path = furi_string_alloc_set(APP_DATA_PATH(""));
     storage_common_resolve_path_and_ensure_app_directory(app->storage, dir_path);
@@ -110,43 +120,89 @@ void tpms_debug_log(ProtoViewApp *app, const char *event, const char *detail) {
 
     bool is_new = !storage_file_exists(app->storage, TPMS_DEBUG_LOG_PATH);
 
-    if (storage_file_open(file, TPMS_DEBUG_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        if (is_new) {
-            const char *header =
-                "ts_ms,event,modulation,scans,coherent,tries,decoded,detail\n";
-            storage_file_write(file, header, strlen(header));
-        }
-
-        uint32_t ts = furi_get_tick();
-        const char *mod_name = ProtoViewModulations[app->modulation].name;
-
-        char line[192];
-        int len = snprintf(
-            line, sizeof(line),
-            "%lu,%s,%s,%lu,%lu,%lu,%lu,%s\n",
-            (unsigned long)ts,
-            event,
-            mod_name,
-            (unsigned long)app->dbg_scan_count,
-            (unsigned long)app->dbg_coherent_count,
-            (unsigned long)app->dbg_decode_try_count,
-            (unsigned long)app->dbg_decode_ok_count,
-            detail ? detail : "");
-
-        storage_file_write(file, line, len);
+    if (!storage_file_open(file, TPMS_DEBUG_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        storage_file_close(file);
+        storage_file_free(file);
+        return NULL;
+    }
+    if (is_new) {
+        const char *header =
+            "ts_ms,event,modulation,scans,coherent,tries,decoded,detail\n";
+        storage_file_write(file, header, strlen(header));
     }
+    return file;
+}
 
+void tpms_debug_log_close(File *file) {
     storage_file_close(file);
     storage_file_free(file);
 }
 
-/* Extract TPMS sensor data from the currently decoded message and
+/* Write a debug event to the debug log 'file', opened with
+ * tpms_debug_log_open().
+ * Format: ts_ms,event,modulation,scans,coherent,tries,decoded,detail */
+void tpms_debug_log_write(ProtoViewApp *app, File *file, const char *event,
+                          const char *detail)
+{
+    uint32_t ts = furi_get_tick();
+    const char *mod_name = ProtoViewModulations[app->modulation].name;
+
+    char line[320];
+    int len = snprintf(
+        line, sizeof(line),
+        "%lu,%s,%s,%lu,%lu,%lu,%lu,%s\n",
+        (unsigned long)ts,
+        event,
+        mod_name,
+        (unsigned long)app->dbg_scan_count,
+        (unsigned long)app->dbg_coherent_count,
+        (unsigned long)app->dbg_decode_try_count,
+        (unsigned long)app->dbg_decode_ok_count,
+        detail ? detail : "");
+
+    storage_file_write(file, line, len);
+}
+
+/* Write a single debug event to the SD card log. */
+void tpms_debug_log(ProtoViewApp *app, const char *event, const char *detail) {
+    File *file = tpms_debug_log_open(app);
+    if (!file) return;
+    tpms_debug_log_write(app, file, event, detail);
+    tpms_debug_log_close(file);
+}
+
+/* Write the scanner counters to the SD card debug log, as a STATS event. */
+void tpms_debug_log_stats(ProtoViewApp *app) {
+    char detail[256];
+    snprintf(detail, sizeof(detail),
+             "deferred=%lu steps=%lu budget_hit=%lu nc_hit=%lu nc_miss=%lu "
+             "rate=%lu/%lu/%lu inv=%lu syncerr=%lu skip=%lu calls=%lu "
+             "conflicts=%lu fixed=%lu combined=%lu",
+             (unsigned long)app->dbg_deferred_count,
+             (unsigned long)app->dbg_scan_step_count,
+             (unsigned long)app->dbg_budget_hit_count,
+             (unsigned long)app->dbg_negcache_hit,
+             (unsigned long)app->dbg_negcache_miss,
+             (unsigned long)app->dbg_rate_wins[RateHypMeasured],
+             (unsigned long)app->dbg_rate_wins[RateHypHalf],
+             (unsigned long)app->dbg_rate_wins[RateHypNominal],
+             (unsigned long)app->dbg_inverted_ok_count,
+             (unsigned long)app->dbg_sync_errors_ok_count,
+             (unsigned long)app->dbg_decoder_skip_count,
+             (unsigned long)app->dbg_decoder_call_count,
+             (unsigned long)app->dbg_decode_conflict_count,
+             (unsigned long)app->dbg_crc_fixed_ok_count,
+             (unsigned long)app->dbg_combined_ok_count);
+    tpms_debug_log(app, "STATS", detail);
+}
+
+/* Extract TPMS sensor data from the decoded message 'info' and
  * add or update it in the sensor list.
  * Returns true if a valid TPMS sensor was extracted. */
-bool tpms_extract_and_store(ProtoViewApp *app) {
-    if (!app->msg_info || !app->msg_info->fieldset) return false;
+bool tpms_extract_and_store(ProtoViewApp *app, ProtoViewMsgInfo *info) {
+    if (!info || !info->fieldset) return false;
 
-    ProtoViewFieldSet *fs = app->msg_info->fieldset;
+    ProtoViewFieldSet *fs = info->fieldset;
     ProtoViewField *id_field = fieldset_find(fs, "Tire ID");
     if (!id_field) return false; /* Not a TPMS message. */
     if (id_field->type != FieldTypeBytes) return false;
@@ -162,7 +218,7 @@ bool tpms_extract_and_store(ProtoViewApp *app) {
 
     /* Protocol name. */
     snprintf(sensor.protocol, sizeof(sensor.protocol), "%s",
-             app->msg_info->decoder->name);
+             info->decoder->name);
 
     /* Extract pressure. Decoders output either "Pressure kpa" or
      * "Pressure psi". Normalize to PSI. */
@@ -219,8 +275,12 @@ bool tpms_extract_and_store(ProtoViewApp *app) {
     if (saved) {
         tpms_save_to_file(app, saved);
     }
+    return true;
+}
 
-    /* Notify the user: vibrate + green LED for new TPMS data. */
+/* Notify the user: vibrate + green LED for new TPMS data. Called once
+ * per scan, however many sensors it stored. */
+void tpms_notify_rx(ProtoViewApp *app) {
     static const NotificationSequence tpms_seq = {
         &message_vibro_on,
         &message_green_255,
@@ -230,6 +290,4 @@ bool tpms_extract_and_store(ProtoViewApp *app) {
         NULL
     };
     notification_message(app->notification, &tpms_seq);
-
-    return true;
 }
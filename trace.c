@@ -0,0 +1,67 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license. */
+
+#include "app.h"
+
+extern ProtoViewDecoder *Decoders[];
+
+/* The ring of the last TRACE_RING_SIZE events. 'next' is the total number
+ * of events recorded, so it also tells if the ring already wrapped. */
+static TraceEvent TraceRing[TRACE_RING_SIZE];
+static uint32_t TraceNext = 0;
+
+static const char *TraceEventNames[TraceEventCount] = {
+    [TraceScanStart] = "SCAN",
+    [TraceCoherent] = "COHERENT",
+    [TraceDecodeTry] = "TRY",
+    [TraceDecoderMatch] = "MATCH",
+    [TraceDecodeOk] = "OK",
+    [TraceDecodeFail] = "FAIL",
+    [TraceCombine] = "COMBINE",
+};
+
+/* Record an event. This is called in the hot path, so it only stores
+ * a few words. */
+void trace_record(TraceEventId id, uint32_t a, uint32_t b) {
+    TraceEvent *e = &TraceRing[TraceNext % TRACE_RING_SIZE];
+    e->cycles = DWT->CYCCNT;
+    e->id = id;
+    e->a = a;
+    e->b = b;
+    TraceNext++;
+}
+
+void trace_reset(void) {
+    TraceNext = 0;
+}
+
+/* Format the events in the ring, oldest first, and write them to the SD
+ * card debug log as TRACE lines, opening the log once for all of them.
+ * Times are in microseconds from the oldest event. The ring is emptied. */
+void trace_dump(ProtoViewApp *app) {
+    uint32_t count = TraceNext < TRACE_RING_SIZE ? TraceNext : TRACE_RING_SIZE;
+    uint32_t first = TraceNext - count;
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    uint32_t start = TraceRing[first % TRACE_RING_SIZE].cycles;
+
+    File *file = count ? tpms_debug_log_open(app) : NULL;
+    for (uint32_t j = first; file && j < TraceNext; j++) {
+        TraceEvent *e = &TraceRing[j % TRACE_RING_SIZE];
+        const char *name = e->id < TraceEventCount ?
+                           TraceEventNames[e->id] : "?";
+        char detail[64];
+        if (e->id == TraceDecoderMatch || e->id == TraceDecodeOk) {
+            snprintf(detail, sizeof(detail), "+%lu %s %s %lu",
+                     (unsigned long)((e->cycles - start) / cycles_per_us),
+                     name, Decoders[e->a]->name, (unsigned long)e->b);
+        } else {
+            snprintf(detail, sizeof(detail), "+%lu %s %lu %lu",
+                     (unsigned long)((e->cycles - start) / cycles_per_us),
+                     name, (unsigned long)e->a, (unsigned long)e->b);
+        }
+        tpms_debug_log_write(app, file, "TRACE", detail);
+    }
+    if (file) tpms_debug_log_close(file);
+    LOG_I("Trace dumped: %lu events", (unsigned long)count);
+    trace_reset();
+}
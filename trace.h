@@ -0,0 +1,85 @@
+/* Copyright (C) 2022-2023 Salvatore Sanfilippo -- All Rights Reserved
+ * See the LICENSE file for information about the license. */
+
+/* Logging levels and binary tracing.
+ *
+ * LOG_E() ... LOG_D() are FURI_LOG_E() ... FURI_LOG_D() when the level is
+ * enabled by TPMS_LOG_LEVEL, and dead code removed by the compiler
+ * otherwise: the arguments are not evaluated. Set the level at build time,
+ * for instance adding "TPMS_LOG_LEVEL=4" to the cdefines of
+ * application.fam.
+ *
+ * The hot path (scanning and decoding) does not format strings at all:
+ * it records TRACE() events in a RAM ring, each with an id, two arguments
+ * and the DWT cycle counter. The ring is only formatted by trace_dump(). */
+
+#pragma once
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef TPMS_LOG_LEVEL
+#define TPMS_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_ENABLED(level) (TPMS_LOG_LEVEL >= (level))
+
+#if LOG_ENABLED(LOG_LEVEL_ERROR)
+#define LOG_E(...) FURI_LOG_E(TAG, __VA_ARGS__)
+#else
+#define LOG_E(...) do { if (0) FURI_LOG_E(TAG, __VA_ARGS__); } while(0)
+#endif
+
+#if LOG_ENABLED(LOG_LEVEL_WARN)
+#define LOG_W(...) FURI_LOG_W(TAG, __VA_ARGS__)
+#else
+#define LOG_W(...) do { if (0) FURI_LOG_W(TAG, __VA_ARGS__); } while(0)
+#endif
+
+#if LOG_ENABLED(LOG_LEVEL_INFO)
+#define LOG_I(...) FURI_LOG_I(TAG, __VA_ARGS__)
+#else
+#define LOG_I(...) do { if (0) FURI_LOG_I(TAG, __VA_ARGS__); } while(0)
+#endif
+
+#if LOG_ENABLED(LOG_LEVEL_DEBUG)
+#define LOG_D(...) FURI_LOG_D(TAG, __VA_ARGS__)
+#else
+#define LOG_D(...) do { if (0) FURI_LOG_D(TAG, __VA_ARGS__); } while(0)
+#endif
+
+/* Tracing is enabled unless TPMS_TRACE is defined as 0. */
+#ifndef TPMS_TRACE
+#define TPMS_TRACE 1
+#endif
+
+#define TRACE_RING_SIZE 64  /* Events kept. Use a power of two. */
+
+typedef enum {
+    TraceScanStart,         /* a: samples received, b: modulation. */
+    TraceCoherent,          /* a: run length, b: short pulse us. */
+    TraceDecodeTry,         /* a: run length, b: rate us. */
+    TraceDecoderMatch,      /* a: decoder index, b: first sync offset. */
+    TraceDecodeOk,          /* a: decoder index, b: rate us. */
+    TraceDecodeFail,        /* a: run length, b: rates tried. */
+    TraceCombine,           /* a: decoder index, b: copies combined. */
+    TraceEventCount
+} TraceEventId;
+
+typedef struct {
+    uint32_t cycles;        /* DWT->CYCCNT when the event was recorded. */
+    uint32_t id;            /* TraceEventId. */
+    uint32_t a, b;          /* Event arguments. */
+} TraceEvent;
+
+#if TPMS_TRACE
+#define TRACE(id, a, b) trace_record((id), (a), (b))
+#else
+#define TRACE(id, a, b) do {} while(0)
+#endif
+
+void trace_record(TraceEventId id, uint32_t a, uint32_t b);
+void trace_reset(void);
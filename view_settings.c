@@ -105,8 +105,8 @@ void process_input_settings(ProtoViewApp *app, InputEvent input) {
 
 void view_exit_settings(ProtoViewApp *app) {
     if (app->txrx->freq_mod_changed) {
-        FURI_LOG_E(TAG, "Setting frequency/modulation to %lu %s",
-                   app->frequency, ProtoViewModulations[app->modulation].name);
+        LOG_I("Setting frequency/modulation to %lu %s",
+              app->frequency, ProtoViewModulations[app->modulation].name);
         radio_rx_end(app);
         radio_begin(app);
         radio_rx(app);
@@ -61,22 +61,31 @@ void render_view_tpms_list(Canvas *const canvas, ProtoViewApp *app) {
         int dots = (ticks / 500) % 4;
         char dot_buf[32];
         snprintf(dot_buf, sizeof(dot_buf), "Scanning%.*s", dots, "...");
-        canvas_draw_str(canvas, 1, 22, dot_buf);
+        canvas_draw_str(canvas, 1, 21, dot_buf);
 
         /* Line 2: Scans performed and current modulation. */
         snprintf(buf, sizeof(buf), "Scans: %lu  Mod: %s",
                  (unsigned long)app->dbg_scan_count,
                  ProtoViewModulations[app->modulation].name);
-        canvas_draw_str(canvas, 1, 32, buf);
+        canvas_draw_str(canvas, 1, 29, buf);
 
         /* Line 3: Signals found and decode attempts. */
         snprintf(buf, sizeof(buf), "Signals: %lu  Decoded: %lu/%lu",
                  (unsigned long)app->dbg_coherent_count,
                  (unsigned long)app->dbg_decode_ok_count,
                  (unsigned long)app->dbg_decode_try_count);
-        canvas_draw_str(canvas, 1, 42, buf);
-
-        /* Line 4: Last signal info (if any signal was seen). */
+        canvas_draw_str(canvas, 1, 37, buf);
+
+        /* Line 4: Scanner load: candidates deferred, steps paused by the
+         * step budget, and negative cache hits/misses. */
+        snprintf(buf, sizeof(buf), "Def:%lu Bud:%lu Cache:%lu/%lu",
+                 (unsigned long)app->dbg_deferred_count,
+                 (unsigned long)app->dbg_budget_hit_count,
+                 (unsigned long)app->dbg_negcache_hit,
+                 (unsigned long)app->dbg_negcache_miss);
+        canvas_draw_str(canvas, 1, 45, buf);
+
+        /* Line 5: Last signal info (if any signal was seen). */
         if (app->dbg_coherent_count > 0) {
             snprintf(buf, sizeof(buf), "Last: %lu samp, %lu us pulse",
                      (unsigned long)app->dbg_last_signal_len,
@@ -84,7 +93,7 @@ void render_view_tpms_list(Canvas *const canvas, ProtoViewApp *app) {
         } else {
             snprintf(buf, sizeof(buf), "No RF signals detected yet");
         }
-        canvas_draw_str(canvas, 1, 52, buf);
+        canvas_draw_str(canvas, 1, 53, buf);
 
         /* Bottom hint. */
         canvas_draw_str(canvas, 1, 63, "LEFT/RIGHT: settings");
@@ -205,6 +214,12 @@ void process_input_tpms_list(ProtoViewApp *app, InputEvent input) {
         }
     }
 
+    if (input.type == InputTypeLong && input.key == InputKeyUp) {
+        /* Write the recent scan/decode trace events to the debug log. */
+        trace_dump(app);
+        ui_show_alert(app, "Trace dumped", 800);
+    }
+
     if (input.type == InputTypeLong && input.key == InputKeyOk) {
         /* Clear the sensor list. */
         tpms_sensor_list_clear(&app->sensor_list);